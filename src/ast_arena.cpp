@@ -0,0 +1,35 @@
+#include "ast_arena.hpp"
+
+#include <cstring>
+
+// First block; every further block is larger than the previous one, so a
+// big AST takes a few dozen upstream allocations
+static const size_t initial_block_size = 64 * 1024;
+
+AstArena::AstArena() : resource(initial_block_size) {}
+
+std::pmr::memory_resource* AstArena::get_resource() noexcept
+{
+    return &resource;
+}
+
+std::string_view AstArena::copy_text(std::string_view text)
+{
+    if (text.empty()) {
+        return std::string_view();
+    }
+    char* copy = static_cast<char*>(resource.allocate(text.size(), 1));
+    memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+void AstArena::release() noexcept
+{
+    resource.release();
+    node_count = 0;
+}
+
+size_t AstArena::get_node_count() const noexcept
+{
+    return node_count;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+// Bump allocator for the AST of one compilation. Nodes, their child lists
+// and copied text are carved out of large blocks that are all released at
+// once with the arena (or by release()): nodes are never destroyed one by
+// one, so a node may only own memory taken from the arena. Child lists are
+// std::pmr containers on get_resource(), names and strings are views of the
+// source or of copy_text().
+class AstArena
+{
+public:
+    AstArena();
+
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    // Constructs a node in the arena
+    template <typename Node, typename... Args>
+    Node* make(Args&&... args)
+    {
+        void* memory = resource.allocate(sizeof(Node), alignof(Node));
+        ++node_count;
+        return new (memory) Node(std::forward<Args>(args)...);
+    }
+
+    // Allocator for the containers of arena nodes
+    std::pmr::memory_resource* get_resource() noexcept;
+
+    // Copy of text that lives as long as the arena
+    std::string_view copy_text(std::string_view text);
+
+    // Frees every node at once; pointers into the arena are dangling after
+    void release() noexcept;
+
+    size_t get_node_count() const noexcept;
+
+private:
+    std::pmr::monotonic_buffer_resource resource;
+    size_t node_count = 0;
+};
@@ -0,0 +1,624 @@
+#include "ast_cache.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string_view>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+#include "node_visitor.hpp"
+#include "section_factory.hpp"
+
+namespace {
+
+const char cache_magic[8] = {'N', 'F', 'A', 'S', 'T', 'C', '\r', '\n'};
+const uint32_t cache_version = 4;
+
+const uint64_t fnv_offset_basis = 14695981039346656037ull;
+
+// Continues a 64-bit FNV-1a hash over length more bytes
+uint64_t hash_bytes(uint64_t hash, const void* data, size_t length) noexcept
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Reference to no node (a section without block)
+const uint32_t no_node = UINT32_MAX;
+
+// Start of the file; the arrays follow it in this order: nodes, children,
+// line starts, pool
+struct CacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t node_count;
+    uint64_t source_hash;
+    uint32_t child_count;
+    uint32_t line_count;
+    uint32_t pool_size;
+    uint32_t reserved;
+    // Hash of everything after the header, so a damaged file is not loaded
+    uint64_t body_hash;
+};
+
+enum class CachedKind : uint16_t {
+    PROGRAM,
+    SECTION,
+    BLOCK,
+    PROPERTY,
+    STRING,
+    NUMBER,
+    BOOLEAN,
+    IP_ADDRESS,
+    IP_CIDR,
+    IP_RANGE,
+    IPV6_ADDRESS,
+    IPV6_CIDR,
+    IPV6_RANGE,
+    LIST
+};
+
+// One node. What first and count hold depends on the kind:
+//   PROGRAM, BLOCK, LIST   range of the child table (sections, statements, values)
+//   SECTION                first: its block; section_type and text: its name
+//   PROPERTY               first: its value; text: its name
+//   STRING                 text: the string as written, quotes included if
+//                          it had them; first: 1 if it was quoted
+//   NUMBER, BOOLEAN        first: the value
+//   IP_ADDRESS             first: the address
+//   IP_CIDR, IP_RANGE      first and count: address and length, first and last
+//   IPV6_*                 text: the bytes of the decoded literal
+struct CachedNode
+{
+    uint16_t kind;
+    uint16_t section_type;
+    uint32_t span_offset;
+    uint32_t span_length;
+    uint32_t text_offset;
+    uint32_t text_length;
+    uint32_t first;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CacheHeader) % alignof(CachedNode) == 0, "nodes must stay aligned in the mapping");
+static_assert(sizeof(CachedNode) % alignof(uint32_t) == 0, "tables must stay aligned in the mapping");
+
+// Flattens a program, children first
+class CacheWriter
+{
+public:
+    bool add_program(const ProgramDeclaration& program)
+    {
+        std::vector<uint32_t> sections;
+        for (size_t i = 0; i < program.get_sections().size(); ++i) {
+            // Imported sections depend on other files, the hash does not cover them
+            if (program.get_section_module(i) != nullptr) {
+                return false;
+            }
+            uint32_t section = add_node(program.get_sections()[i]);
+            if (section == no_node) {
+                return false;
+            }
+            sections.push_back(section);
+        }
+        CachedNode node = make_node(CachedKind::PROGRAM, program);
+        add_children(node, sections);
+        nodes.push_back(node);
+        return true;
+    }
+
+    std::vector<CachedNode> nodes;
+    std::vector<uint32_t> children;
+    std::string pool;
+
+private:
+    CachedNode make_node(CachedKind kind, const ASTNodeInterface& source) const noexcept
+    {
+        CachedNode node{};
+        node.kind = static_cast<uint16_t>(kind);
+        node.span_offset = source.get_span().offset;
+        node.span_length = source.get_span().length;
+        return node;
+    }
+
+    uint32_t push(const CachedNode& node)
+    {
+        nodes.push_back(node);
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    // Stores text in the pool once, however many nodes use it
+    void set_text(CachedNode& node, std::string_view text)
+    {
+        auto pooled = pool_offsets.find(text);
+        if (pooled == pool_offsets.end()) {
+            uint32_t offset = static_cast<uint32_t>(pool.size());
+            pool.append(text.data(), text.size());
+            pooled = pool_offsets.emplace(std::string_view(text), offset).first;
+        }
+        node.text_offset = pooled->second;
+        node.text_length = static_cast<uint32_t>(text.size());
+    }
+
+    template <typename Literal>
+    void set_bytes(CachedNode& node, const Literal& literal)
+    {
+        node.text_offset = static_cast<uint32_t>(pool.size());
+        node.text_length = sizeof(Literal);
+        pool.append(reinterpret_cast<const char*>(&literal), sizeof(Literal));
+    }
+
+    void add_children(CachedNode& node, const std::vector<uint32_t>& indexes)
+    {
+        node.first = static_cast<uint32_t>(children.size());
+        node.count = static_cast<uint32_t>(indexes.size());
+        children.insert(children.end(), indexes.begin(), indexes.end());
+    }
+
+    // Adds node and everything under it, no_node if the cache cannot hold it
+    uint32_t add_node(const ASTNodeInterface* node)
+    {
+        if (node == nullptr) {
+            return no_node;
+        }
+        return visit_node(*node, [this](const auto& concrete) { return add(concrete); });
+    }
+
+    // Every specialized section, by its name and section type
+    uint32_t add(const SectionStatement& section)
+    {
+        uint32_t block = no_node;
+        if (section.get_block() != nullptr) {
+            block = add(*section.get_block());
+            if (block == no_node) {
+                return no_node;
+            }
+        }
+        CachedNode node = make_node(CachedKind::SECTION, section);
+        node.section_type = static_cast<uint16_t>(section.get_section_type());
+        node.first = block;
+        set_text(node, section.get_name());
+        return push(node);
+    }
+
+    uint32_t add(const PropertyStatement& property)
+    {
+        uint32_t value = add_node(property.get_value());
+        if (value == no_node) {
+            return no_node;
+        }
+        CachedNode node = make_node(CachedKind::PROPERTY, property);
+        node.first = value;
+        set_text(node, property.get_name());
+        return push(node);
+    }
+
+    uint32_t add(const BlockStatement& block)
+    {
+        std::vector<uint32_t> statements;
+        for (const Statement* statement : block.get_statements()) {
+            uint32_t index = add_node(statement);
+            if (index == no_node) {
+                return no_node;
+            }
+            statements.push_back(index);
+        }
+        CachedNode node = make_node(CachedKind::BLOCK, block);
+        add_children(node, statements);
+        return push(node);
+    }
+
+    uint32_t add(const ListValue& list)
+    {
+        std::vector<uint32_t> values;
+        for (const Value* value : list.get_values()) {
+            uint32_t index = add_node(value);
+            if (index == no_node) {
+                return no_node;
+            }
+            values.push_back(index);
+        }
+        CachedNode node = make_node(CachedKind::LIST, list);
+        add_children(node, values);
+        return push(node);
+    }
+
+    uint32_t add(const StringValue& value)
+    {
+        CachedNode node = make_node(CachedKind::STRING, value);
+        set_text(node, value.get_literal());
+        node.first = value.is_quoted() ? 1 : 0;
+        return push(node);
+    }
+
+    uint32_t add(const NumberValue& value)
+    {
+        CachedNode node = make_node(CachedKind::NUMBER, value);
+        node.first = static_cast<uint32_t>(value.get_value());
+        return push(node);
+    }
+
+    uint32_t add(const BooleanValue& value)
+    {
+        CachedNode node = make_node(CachedKind::BOOLEAN, value);
+        node.first = value.get_value() ? 1 : 0;
+        return push(node);
+    }
+
+    uint32_t add(const IPAddressValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IP_ADDRESS, value);
+        node.first = value.get_address();
+        return push(node);
+    }
+
+    uint32_t add(const IPCIDRValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IP_CIDR, value);
+        node.first = value.get_prefix().address;
+        node.count = value.get_prefix().length;
+        return push(node);
+    }
+
+    uint32_t add(const IPRangeValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IP_RANGE, value);
+        node.first = value.get_range().first;
+        node.count = value.get_range().last;
+        return push(node);
+    }
+
+    uint32_t add(const IPv6AddressValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IPV6_ADDRESS, value);
+        set_bytes(node, value.get_address());
+        return push(node);
+    }
+
+    uint32_t add(const IPv6CIDRValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IPV6_CIDR, value);
+        set_bytes(node, value.get_prefix());
+        return push(node);
+    }
+
+    uint32_t add(const IPv6RangeValue& value)
+    {
+        CachedNode node = make_node(CachedKind::IPV6_RANGE, value);
+        set_bytes(node, value.get_range());
+        return push(node);
+    }
+
+    // The parser builds no other nodes under a program
+    uint32_t add(const ASTNodeInterface&)
+    {
+        return no_node;
+    }
+
+    std::unordered_map<std::string_view, uint32_t> pool_offsets;
+};
+
+// The parts of a mapped cache file, once its sizes have been checked
+struct CacheView
+{
+    const CachedNode* nodes;
+    const uint32_t* children;
+    const uint32_t* line_starts;
+    const char* pool;
+    const CacheHeader* header;
+};
+
+bool is_value_kind(uint16_t kind) noexcept
+{
+    return kind >= static_cast<uint16_t>(CachedKind::STRING) && kind <= static_cast<uint16_t>(CachedKind::IPV6_RANGE);
+}
+
+bool is_statement_kind(uint16_t kind) noexcept
+{
+    return kind == static_cast<uint16_t>(CachedKind::SECTION) || kind == static_cast<uint16_t>(CachedKind::PROPERTY);
+}
+
+// True if child is an earlier node accepted by check
+template <typename Check>
+bool check_reference(const CacheView& view, uint32_t index, uint32_t child, Check check) noexcept
+{
+    return child < index && check(view.nodes[child].kind);
+}
+
+template <typename Check>
+bool check_children(const CacheView& view, uint32_t index, Check check) noexcept
+{
+    const CachedNode& node = view.nodes[index];
+    if (node.first > view.header->child_count || node.count > view.header->child_count - node.first) {
+        return false;
+    }
+    for (uint32_t i = 0; i < node.count; ++i) {
+        if (!check_reference(view, index, view.children[node.first + i], check)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks every node before any is built: references point back to nodes
+// of the right kind, text lies in the pool, literals have their size
+bool check_nodes(const CacheView& view) noexcept
+{
+    const uint32_t node_count = view.header->node_count;
+    if (node_count == 0 || view.nodes[node_count - 1].kind != static_cast<uint16_t>(CachedKind::PROGRAM)) {
+        return false;
+    }
+    for (uint32_t index = 0; index < node_count; ++index) {
+        const CachedNode& node = view.nodes[index];
+        if (node.text_offset > view.header->pool_size || node.text_length > view.header->pool_size - node.text_offset) {
+            return false;
+        }
+        bool valid = true;
+        switch (static_cast<CachedKind>(node.kind)) {
+            case CachedKind::PROGRAM:
+                valid = check_children(view, index, [](uint16_t kind) {
+                    return kind == static_cast<uint16_t>(CachedKind::SECTION);
+                });
+                break;
+            case CachedKind::SECTION:
+                valid = node.section_type <= static_cast<uint16_t>(SectionStatement::SectionType::CUSTOM) &&
+                        (node.first == no_node || check_reference(view, index, node.first, [](uint16_t kind) {
+                             return kind == static_cast<uint16_t>(CachedKind::BLOCK);
+                         }));
+                break;
+            case CachedKind::BLOCK:
+                valid = check_children(view, index, is_statement_kind);
+                break;
+            case CachedKind::PROPERTY:
+                valid = check_reference(view, index, node.first, [](uint16_t kind) {
+                    return is_value_kind(kind) || kind == static_cast<uint16_t>(CachedKind::LIST);
+                });
+                break;
+            case CachedKind::LIST:
+                valid = check_children(view, index, is_value_kind);
+                break;
+            case CachedKind::IPV6_ADDRESS:
+                valid = node.text_length == sizeof(IPv6Address);
+                break;
+            case CachedKind::IPV6_CIDR:
+                valid = node.text_length == sizeof(IPv6Prefix);
+                break;
+            case CachedKind::IPV6_RANGE:
+                valid = node.text_length == sizeof(IPv6Range);
+                break;
+            case CachedKind::STRING:
+            case CachedKind::NUMBER:
+            case CachedKind::BOOLEAN:
+            case CachedKind::IP_ADDRESS:
+            case CachedKind::IP_CIDR:
+            case CachedKind::IP_RANGE:
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Literal>
+Literal read_bytes(const CacheView& view, const CachedNode& node) noexcept
+{
+    Literal literal;
+    memcpy(&literal, view.pool + node.text_offset, sizeof(Literal));
+    return literal;
+}
+
+// Builds node index of a checked cache in the arena; its children are built
+ASTNodeInterface* build_node(AstArena& arena, const CacheView& view, uint32_t index,
+                             const std::vector<ASTNodeInterface*>& built)
+{
+    const CachedNode& node = view.nodes[index];
+    std::string_view text(view.pool + node.text_offset, node.text_length);
+    ASTNodeInterface* result = nullptr;
+    switch (static_cast<CachedKind>(node.kind)) {
+        case CachedKind::PROGRAM: {
+            auto program = arena.make<ProgramDeclaration>(arena.get_resource());
+            for (uint32_t i = 0; i < node.count; ++i) {
+                program->add_section(static_cast<SectionStatement*>(built[view.children[node.first + i]]));
+            }
+            result = program;
+            break;
+        }
+        case CachedKind::SECTION: {
+            auto block = node.first == no_node ? nullptr : static_cast<BlockStatement*>(built[node.first]);
+            result = SectionFactory::create_section(
+                arena, text, static_cast<SectionStatement::SectionType>(node.section_type), block);
+            break;
+        }
+        case CachedKind::BLOCK: {
+            auto block = arena.make<BlockStatement>(arena.get_resource());
+            for (uint32_t i = 0; i < node.count; ++i) {
+                block->add_statement(static_cast<Statement*>(built[view.children[node.first + i]]));
+            }
+            block->index_properties();
+            result = block;
+            break;
+        }
+        case CachedKind::PROPERTY:
+            result = arena.make<PropertyStatement>(text, static_cast<Expression*>(built[node.first]), intern_symbol(text));
+            break;
+        case CachedKind::LIST: {
+            ValueList values(arena.get_resource());
+            values.reserve(node.count);
+            for (uint32_t i = 0; i < node.count; ++i) {
+                values.push_back(static_cast<Value*>(built[view.children[node.first + i]]));
+            }
+            result = arena.make<ListValue>(std::move(values));
+            break;
+        }
+        case CachedKind::STRING:
+            result = arena.make<StringValue>(text, node.first != 0);
+            break;
+        case CachedKind::NUMBER:
+            result = arena.make<NumberValue>(static_cast<int>(node.first));
+            break;
+        case CachedKind::BOOLEAN:
+            result = arena.make<BooleanValue>(node.first != 0);
+            break;
+        case CachedKind::IP_ADDRESS:
+            result = arena.make<IPAddressValue>(node.first);
+            break;
+        case CachedKind::IP_CIDR:
+            result = arena.make<IPCIDRValue>(IPv4Prefix{node.first, static_cast<uint8_t>(node.count)});
+            break;
+        case CachedKind::IP_RANGE:
+            result = arena.make<IPRangeValue>(IPv4Range{node.first, node.count});
+            break;
+        case CachedKind::IPV6_ADDRESS:
+            result = arena.make<IPv6AddressValue>(read_bytes<IPv6Address>(view, node));
+            break;
+        case CachedKind::IPV6_CIDR:
+            result = arena.make<IPv6CIDRValue>(read_bytes<IPv6Prefix>(view, node));
+            break;
+        case CachedKind::IPV6_RANGE:
+            result = arena.make<IPv6RangeValue>(read_bytes<IPv6Range>(view, node));
+            break;
+    }
+    result->set_span(SourceSpan{node.span_offset, node.span_length});
+    return result;
+}
+
+} // namespace
+
+uint64_t hash_source(const char* data, size_t length) noexcept
+{
+    return hash_bytes(fnv_offset_basis, data, length);
+}
+
+bool hash_source_file(const std::string& path, uint64_t& hash)
+{
+    SourceBuffer source;
+    if (!source.open(path)) {
+        return false;
+    }
+    hash = hash_source(source.get_data(), source.get_size());
+    return true;
+}
+
+std::string ast_cache_path(const std::string& output_filename)
+{
+    if (output_filename.empty() || output_filename == "-") {
+        return std::string();
+    }
+    std::string_view stem = output_filename;
+    if (stem.size() > 4 && stem.substr(stem.size() - 4) == ".rsc") {
+        stem.remove_suffix(4);
+    }
+    return std::string(stem) + ".astc";
+}
+
+bool write_ast_cache(const std::string& path, const ProgramDeclaration& program, const LineIndex& line_index,
+                     uint64_t source_hash)
+{
+    CacheWriter writer;
+    if (!writer.add_program(program)) {
+        return false;
+    }
+    const std::vector<uint32_t>& line_starts = line_index.get_line_starts();
+
+    CacheHeader header{};
+    memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.node_count = static_cast<uint32_t>(writer.nodes.size());
+    header.source_hash = source_hash;
+    header.child_count = static_cast<uint32_t>(writer.children.size());
+    header.line_count = static_cast<uint32_t>(line_starts.size());
+    header.pool_size = static_cast<uint32_t>(writer.pool.size());
+
+    // The body, in file order
+    const std::pair<const void*, size_t> body[] = {
+        {writer.nodes.data(), writer.nodes.size() * sizeof(CachedNode)},
+        {writer.children.data(), writer.children.size() * sizeof(uint32_t)},
+        {line_starts.data(), line_starts.size() * sizeof(uint32_t)},
+        {writer.pool.data(), writer.pool.size()},
+    };
+    header.body_hash = fnv_offset_basis;
+    for (const auto& [data, size] : body) {
+        header.body_hash = hash_bytes(header.body_hash, data, size);
+    }
+
+    // A file of its own in the same directory, renamed over path once it is
+    // complete: readers map either the old cache or the new one
+    std::string temporary = path + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0) {
+        return false;
+    }
+    FILE* file = fdopen(fd, "wb");
+    if (file == nullptr) {
+        close(fd);
+        remove(temporary.c_str());
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const auto& [data, size] : body) {
+        written = written && (size == 0 || fwrite(data, size, 1, file) == 1);
+    }
+    // mkstemp creates the file for its owner only
+    written = fchmod(fd, 0644) == 0 && written;
+    if (fclose(file) != 0 || !written || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool load_ast_cache(ParserContext& ctx, const std::string& path, uint64_t source_hash)
+{
+    SourceBuffer& file = ctx.source;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    // The mapping is page aligned, the header and tables keep their alignment
+    CacheView view{};
+    view.header = reinterpret_cast<const CacheHeader*>(file.get_data());
+    const CacheHeader& header = *view.header;
+    bool valid = file.get_size() >= sizeof(CacheHeader) && memcmp(header.magic, cache_magic, sizeof(cache_magic)) == 0 &&
+                 header.version == cache_version && header.source_hash == source_hash &&
+                 file.get_size() == sizeof(CacheHeader) + uint64_t(header.node_count) * sizeof(CachedNode) +
+                                        (uint64_t(header.child_count) + header.line_count) * sizeof(uint32_t) +
+                                        header.pool_size &&
+                 header.body_hash == hash_bytes(fnv_offset_basis, file.get_data() + sizeof(CacheHeader),
+                                                file.get_size() - sizeof(CacheHeader));
+    if (valid) {
+        view.nodes = reinterpret_cast<const CachedNode*>(file.get_data() + sizeof(CacheHeader));
+        view.children = reinterpret_cast<const uint32_t*>(view.nodes + header.node_count);
+        view.line_starts = view.children + header.child_count;
+        view.pool = reinterpret_cast<const char*>(view.line_starts + header.line_count);
+        valid = check_nodes(view);
+    }
+    if (!valid) {
+        file.close();
+        return false;
+    }
+
+    std::vector<ASTNodeInterface*> built(header.node_count);
+    for (uint32_t index = 0; index < header.node_count; ++index) {
+        built[index] = build_node(ctx.arena, view, index, built);
+    }
+    for (uint32_t line = 0; line < header.line_count; ++line) {
+        ctx.line_index.add_line(view.line_starts[line]);
+    }
+    ctx.result = static_cast<ProgramDeclaration*>(built.back());
+    ctx.documents.push_back(Document{ctx.result, {}});
+    return true;
+}
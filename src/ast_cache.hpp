@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "declaration.hpp"
+#include "parser_context.hpp"
+
+// Binary cache of a parsed program, so an unchanged file can be validated
+// and compiled again without lexing and parsing it. The file holds a header
+// (magic, format version, hash of the source it was parsed from, hash of
+// the rest of the file, checked before it is used), the nodes
+// in a flat array addressed by index (children before their parents, the
+// program last), the child lists of blocks and lists, the line starts of the
+// source (for diagnostics) and a pool of the names and strings, each stored
+// once. Bump the version whenever the layout or the AST it describes changes.
+//
+// Loading maps the file into ctx.source and rebuilds the nodes in ctx.arena:
+// names and strings point into the mapping, nothing is allocated per node.
+
+// 64-bit FNV-1a hash of the source text, the cache key
+uint64_t hash_source(const char* data, size_t length) noexcept;
+
+// Hash of the file at path; false if it cannot be read
+bool hash_source_file(const std::string& path, uint64_t& hash);
+
+// Cache file kept alongside the script output_filename ("x.dsl.rsc" caches
+// in "x.dsl.astc"); "" when there is nowhere to keep it (stdout)
+std::string ast_cache_path(const std::string& output_filename);
+
+// Writes program, parsed from a source with hash source_hash and located
+// through line_index, to path (through a temporary file, so a concurrent
+// reader never sees half a cache). Returns false if it cannot be written.
+bool write_ast_cache(const std::string& path, const ProgramDeclaration& program, const LineIndex& line_index,
+                     uint64_t source_hash);
+
+// Loads the program cached at path into ctx (result, documents and
+// line_index) if the cache is valid, of this format version and for a
+// source with hash source_hash. ctx must be fresh; false leaves it unused.
+bool load_ast_cache(ParserContext& ctx, const std::string& path, uint64_t source_hash);
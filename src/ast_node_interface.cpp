@@ -3,30 +3,6 @@
 #include "declaration.hpp"
 #include <sstream>
 
-// Implementation of helper function to destroy a list of statements
-void destroy_statements(StatementList& statements) noexcept
-{
-    for (auto* statement : statements)
-    {
-        if (statement)
-        {
-            statement->destroy();
-            delete statement;
-        }
-    }
-    statements.clear();
-}
-
-// Implementation of helper function to safely destroy a program declaration
-void destroy_program(ProgramDeclaration* program) noexcept
-{
-    if (program)
-    {
-        program->destroy();
-        delete program;
-    }
-}
-
 std::string body_to_mikrotik(const Body& body, const std::string& ident) noexcept
 {
     std::stringstream result;
@@ -49,5 +25,16 @@ std::string body_to_mikrotik(const Body& body, const std::string& ident) noexcep
     return result.str();
 }
 
+ASTNodeInterface::ASTNodeInterface(NodeKind node_kind) noexcept : kind(node_kind) {}
+
 // Virtual destructor implementation
-ASTNodeInterface::~ASTNodeInterface() noexcept {} 
\ No newline at end of file
+ASTNodeInterface::~ASTNodeInterface() noexcept {} 
+SourceSpan ASTNodeInterface::get_span() const noexcept
+{
+    return span;
+}
+
+void ASTNodeInterface::set_span(SourceSpan node_span) noexcept
+{
+    span = node_span;
+}
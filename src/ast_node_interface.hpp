@@ -1,11 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <list>
 #include <forward_list>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "source_span.hpp"
+
 // Forward declarations of main node types
 class Declaration;
 class Expression;
@@ -16,26 +20,91 @@ class Property;
 class Value;
 class ProgramDeclaration;
 using Body = std::list<Statement*>;
-// Type aliases for common structures
-using StatementList = std::vector<Statement*>;
+// Type aliases for common structures. Node lists are allocated from the
+// AstArena of the compilation (see ast_arena.hpp).
+using StatementList = std::pmr::vector<Statement*>;
 using PropertyList = std::vector<Property*>;
-using ValueList = std::vector<Value*>;
+using ValueList = std::pmr::vector<Value*>;
 
-// Helper function to destroy a list of statements
-void destroy_statements(StatementList& statements) noexcept;
-// Helper function to safely destroy a program declaration
-void destroy_program(ProgramDeclaration* program) noexcept;
 std::string body_to_mikrotik(const Body& body, const std::string& ident) noexcept;
-// Base interface for all AST nodes
+// Class of a node, stored in the node so its type is a byte compare instead
+// of an RTTI lookup (see node_cast and node_visitor.hpp). A class with
+// subclasses owns the contiguous range of their kinds, its classof() tests
+// the range: a new node class goes inside the range of its base class.
+enum class NodeKind : uint8_t {
+    // Statements
+    PROPERTY_STATEMENT,
+    BLOCK_STATEMENT,
+    DECLARATION_STATEMENT,
+    SECTION_STATEMENT,
+    // Sections built by the SectionFactory (SpecializedSection)
+    DEVICE_SECTION,
+    SYSTEM_SECTION,           // A DeviceSection
+    INTERFACES_SECTION,
+    IP_SECTION,
+    ROUTING_SECTION,
+    FIREWALL_SECTION,
+    CUSTOM_SECTION,
+    // Expressions, literal values first (Value)
+    STRING_VALUE,
+    NUMBER_VALUE,
+    BOOLEAN_VALUE,
+    IP_ADDRESS_VALUE,
+    IP_CIDR_VALUE,
+    IP_RANGE_VALUE,
+    IPV6_ADDRESS_VALUE,
+    IPV6_CIDR_VALUE,
+    IPV6_RANGE_VALUE,
+    LIST_VALUE,
+    IDENTIFIER_EXPRESSION,
+    PROPERTY_REFERENCE,
+    // Declarations
+    CONFIG_DECLARATION,
+    PROGRAM_DECLARATION,
+    // Types (Datatype and its subclasses share one kind)
+    DATATYPE
+};
+
+// True if kind lies in [first, last], for the classof() of base classes
+constexpr bool kind_in(NodeKind kind, NodeKind first, NodeKind last) noexcept
+{
+    return kind >= first && kind <= last;
+}
+
+// Base interface for all AST nodes. Parsed nodes live in the AstArena of
+// the compilation and are freed with it, never destroyed one by one.
 class ASTNodeInterface
 {
 public:
+    explicit ASTNodeInterface(NodeKind node_kind) noexcept;
     virtual ~ASTNodeInterface() noexcept;
-    
-    // Method to properly destroy the node and its children
-    virtual void destroy() noexcept = 0;
+
+    NodeKind get_kind() const noexcept { return kind; }
     
     // Method to generate a string representation (useful for debugging)
     virtual std::string to_string() const = 0;
     virtual std::string to_mikrotik(const std::string& ident) const = 0;
-}; 
\ No newline at end of file
+
+    // Input range the node was parsed from, set by the parser
+    SourceSpan get_span() const noexcept;
+    void set_span(SourceSpan node_span) noexcept;
+
+private:
+    SourceSpan span{0, 0};
+    NodeKind kind;
+};
+
+// Checked downcast by kind tag, the replacement for dynamic_cast on AST
+// nodes: node as a Node if Node::classof() accepts its kind, else nullptr
+// (also for a null node)
+template <typename Node>
+const Node* node_cast(const ASTNodeInterface* node) noexcept
+{
+    return node != nullptr && Node::classof(node->get_kind()) ? static_cast<const Node*>(node) : nullptr;
+}
+
+template <typename Node>
+Node* node_cast(ASTNodeInterface* node) noexcept
+{
+    return node != nullptr && Node::classof(node->get_kind()) ? static_cast<Node*>(node) : nullptr;
+} 
\ No newline at end of file
@@ -0,0 +1,225 @@
+// AST benchmark: parses a DSL file repeated many times (complex.dsl x 878
+// is about 100k property rules), then validates it, generates the RouterOS
+// script and tears the AST down, timing each phase and counting the heap
+// allocations of the parse (make bench-ast). It also copies the AST to a
+// FlatAst and compares the memory and a full-tree pass of both.
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "flat_ast.hpp"
+#include "parser_context.hpp"
+#include "specialized_sections.hpp"
+
+static size_t allocation_count = 0;
+static size_t allocated_bytes = 0;
+
+void* operator new(size_t size)
+{
+    ++allocation_count;
+    allocated_bytes += size;
+    if (void* memory = malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+// The blocks of the AstArena come from the aligned forms
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    ++allocation_count;
+    allocated_bytes += size;
+    size_t align = static_cast<size_t>(alignment);
+    if (void* memory = aligned_alloc(align, (size + align - 1) / align * align)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    free(memory);
+}
+
+// Discards the generated script, only its production is timed
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+static size_t count_properties(const BlockStatement* block)
+{
+    size_t count = 0;
+    for (const Statement* statement : block->get_statements()) {
+        if (node_cast<PropertyStatement>(statement)) {
+            ++count;
+        } else if (auto* section = node_cast<SectionStatement>(statement)) {
+            if (section->get_block()) {
+                count += count_properties(section->get_block());
+            }
+        }
+    }
+    return count;
+}
+
+static size_t count_flat_properties(const FlatAst& ast)
+{
+    size_t count = 0;
+    for (FlatAst::Index node = 0; node < ast.size(); ++node) {
+        if (ast.get_kind(node) == NodeKind::PROPERTY_STATEMENT) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        printf("Usage: %s input_file [repeat]\n", argv[0]);
+        return 1;
+    }
+    int repeat = argc == 3 ? atoi(argv[2]) : 878;
+
+    std::ifstream source_file(argv[1]);
+    if (!source_file.is_open()) {
+        printf("Could not open %s\n", argv[1]);
+        return 1;
+    }
+    std::stringstream source;
+    source << source_file.rdbuf();
+    std::string unit = source.str();
+    if (!unit.empty() && unit.back() != '\n') {
+        unit += '\n';
+    }
+
+    // Top-level sections end at column 0, so copies can simply follow each other
+    char path[] = "/tmp/netforge_ast_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    for (int i = 0; i < repeat; ++i) {
+        if (write(fd, unit.data(), unit.size()) != static_cast<ssize_t>(unit.size())) {
+            perror("write");
+            unlink(path);
+            return 1;
+        }
+    }
+    close(fd);
+
+    double best[4] = {0, 0, 0, 0};  // parse, validate, generate, teardown
+    double best_flat[3] = {0, 0, 0};  // flatten, pass over the AST, pass over the FlatAst
+    size_t allocations = 0;
+    size_t parse_bytes = 0;
+    size_t flat_bytes = 0;
+    size_t properties = 0;
+
+    // Best of a few runs, each on a fresh context (the mapping stays cached)
+    for (int run = 0; run < 5; ++run) {
+        double phase[4];
+        double flat_phase[3];
+        {
+            ParserContext ctx;
+            size_t allocations_before = allocation_count;
+            size_t bytes_before = allocated_bytes;
+            auto start = std::chrono::steady_clock::now();
+            if (netforge_parse_path(ctx, path) != 0 || !ctx.result) {
+                printf("Could not parse %s\n", path);
+                unlink(path);
+                return 1;
+            }
+            phase[0] = seconds_since(start);
+            allocations = allocation_count - allocations_before;
+            parse_bytes = allocated_bytes - bytes_before;
+
+            start = std::chrono::steady_clock::now();
+            for (const auto* section : ctx.result->get_sections()) {
+                if (auto* specialized = node_cast<SpecializedSection>(section)) {
+                    SourceSpan error_span = specialized->get_span();
+                    specialized->validate(error_span);
+                }
+            }
+            phase[1] = seconds_since(start);
+
+            NullBuffer null_buffer;
+            std::ostream null_stream(&null_buffer);
+            start = std::chrono::steady_clock::now();
+            ctx.result->write_mikrotik(null_stream, "");
+            phase[2] = seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            FlatAst flat(*ctx.result);
+            flat_phase[0] = seconds_since(start);
+            flat_bytes = flat.memory_size();
+
+            start = std::chrono::steady_clock::now();
+            properties = 0;
+            for (const auto* section : ctx.result->get_sections()) {
+                if (section->get_block()) {
+                    properties += count_properties(section->get_block());
+                }
+            }
+            flat_phase[1] = seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            size_t flat_properties = count_flat_properties(flat);
+            flat_phase[2] = seconds_since(start);
+            if (flat_properties != properties) {
+                printf("FlatAst has %zu rules, the AST %zu\n", flat_properties, properties);
+            }
+
+            // The whole AST goes with its arena
+            start = std::chrono::steady_clock::now();
+            ctx.arena.release();
+            ctx.result = nullptr;
+            phase[3] = seconds_since(start);
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (run == 0 || phase[i] < best[i]) {
+                best[i] = phase[i];
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (run == 0 || flat_phase[i] < best_flat[i]) {
+                best_flat[i] = flat_phase[i];
+            }
+        }
+    }
+    unlink(path);
+
+    printf("%zu rules, %zu allocations while parsing\n", properties, allocations);
+    printf("parse %.3f s, validate %.3f s, generate %.3f s, teardown %.6f s\n",
+           best[0], best[1], best[2], best[3]);
+    printf("AST %.1f MB allocated while parsing, FlatAst %.1f MB (flattened in %.3f s)\n",
+           parse_bytes / 1e6, flat_bytes / 1e6, best_flat[0]);
+    printf("rule count pass: AST %.4f s, FlatAst %.4f s\n", best_flat[1], best_flat[2]);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Lexer throughput benchmark: builds a large input by repeating a DSL file
+// and times yylex() over it with the backend selected at build time
+// (make bench LEXER=flex|handwritten, or make bench-compare for both).
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "parser_context.hpp"
+#include "scanner.hpp"
+
+#ifndef NETFORGE_LEXER
+#define NETFORGE_LEXER "unknown"
+#endif
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        printf("Usage: %s input_file [repeat]\n", argv[0]);
+        return 1;
+    }
+    int repeat = argc == 3 ? atoi(argv[2]) : 1000;
+
+    std::ifstream source_file(argv[1]);
+    if (!source_file.is_open()) {
+        printf("Could not open %s\n", argv[1]);
+        return 1;
+    }
+    std::stringstream source;
+    source << source_file.rdbuf();
+    std::string unit = source.str();
+    if (!unit.empty() && unit.back() != '\n') {
+        unit += '\n';
+    }
+
+    // Top-level sections end at column 0, so copies can simply follow each other
+    char path[] = "/tmp/netforge_lexer_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    for (int i = 0; i < repeat; ++i) {
+        if (write(fd, unit.data(), unit.size()) != static_cast<ssize_t>(unit.size())) {
+            perror("write");
+            unlink(path);
+            return 1;
+        }
+    }
+    close(fd);
+
+    double input_mb = static_cast<double>(unit.size()) * repeat / (1024.0 * 1024.0);
+    double best_seconds = 0;
+    long tokens = 0;
+
+    // Best of a few runs, each on a fresh context (the mapping stays cached)
+    for (int run = 0; run < 5; ++run) {
+        ParserContext ctx;
+        if (netforge_scan_begin(ctx, path) != 0) {
+            printf("Could not scan %s\n", path);
+            unlink(path);
+            return 1;
+        }
+
+        YYSTYPE value;
+        YYLTYPE location;
+        long count = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (yylex(&value, &location, &ctx) != 0) {
+            ++count;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        netforge_scan_end(ctx);
+
+        if (run == 0 || elapsed.count() < best_seconds) {
+            best_seconds = elapsed.count();
+        }
+        tokens = count;
+    }
+    unlink(path);
+
+    printf("%-12s %8.1f MB %10ld tokens %8.3f s %8.1f MB/s %8.2f Mtokens/s\n",
+           NETFORGE_LEXER, input_mb, tokens, best_seconds,
+           input_mb / best_seconds, tokens / best_seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Incremental reparse benchmark: parses a DSL file repeated until it has
+// some 200k lines, then changes one value at a time (an mtu, a port or any
+// other number) and times the reparse of each edit against a parse of the
+// whole text (make bench-reparse).
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "incremental.hpp"
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        printf("Usage: %s input_file [lines] [edits]\n", argv[0]);
+        return 1;
+    }
+    size_t target_lines = argc >= 3 ? atol(argv[2]) : 200000;
+    int edits = argc == 4 ? atoi(argv[3]) : 1000;
+
+    std::ifstream source_file(argv[1]);
+    if (!source_file.is_open()) {
+        printf("Could not open %s\n", argv[1]);
+        return 1;
+    }
+    std::stringstream source;
+    source << source_file.rdbuf();
+    std::string unit = source.str();
+    if (!unit.empty() && unit.back() != '\n') {
+        unit += '\n';
+    }
+    size_t unit_lines = std::count(unit.begin(), unit.end(), '\n');
+    if (unit_lines == 0) {
+        printf("%s is empty\n", argv[1]);
+        return 1;
+    }
+
+    // Top-level sections end at column 0, so copies can simply follow each other
+    std::string text;
+    for (size_t lines = 0; lines < target_lines; lines += unit_lines) {
+        text += unit;
+    }
+
+    // First digits of the "= <number>" values, the edits change one of them
+    std::vector<size_t> digits;
+    for (size_t position = text.find("= "); position != std::string::npos; position = text.find("= ", position + 1)) {
+        size_t end = position + 2;
+        while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+            ++end;
+        }
+        if (end > position + 2 && end < text.size() && text[end] == '\n' && text[position + 2] != '0') {
+            digits.push_back(position + 2);
+        }
+    }
+    if (digits.empty()) {
+        printf("No numeric value to edit in %s\n", argv[1]);
+        return 1;
+    }
+
+    IncrementalProgram program;
+    auto start = std::chrono::steady_clock::now();
+    if (program.parse(text) != 0) {
+        printf("Could not parse %s\n", argv[1]);
+        return 1;
+    }
+    double full_parse = seconds_since(start);
+
+    srand(1);
+    double total = 0;
+    double slowest = 0;
+    size_t reparsed = 0;
+    for (int i = 0; i < edits; ++i) {
+        size_t offset = digits[rand() % digits.size()];
+        char digit = static_cast<char>('1' + rand() % 9);
+        start = std::chrono::steady_clock::now();
+        int result = program.edit(offset, 1, std::string_view(&digit, 1));
+        double elapsed = seconds_since(start);
+        if (result != 0) {
+            printf("Edit %d at offset %zu does not parse\n", i, offset);
+            return 1;
+        }
+        total += elapsed;
+        slowest = std::max(slowest, elapsed);
+        reparsed += program.get_reparsed_bytes();
+    }
+
+    // The edited program must be the one a parse from scratch gives
+    IncrementalProgram check;
+    if (check.parse(program.get_text()) != 0 ||
+        check.get_result()->to_string() != program.get_result()->to_string()) {
+        printf("Incremental result differs from a full parse\n");
+        return 1;
+    }
+
+    printf("%zu lines, %zu chunks, full parse %.3f s\n",
+           static_cast<size_t>(std::count(text.begin(), text.end(), '\n')), program.get_chunk_count(), full_parse);
+    printf("%d one-line edits: %.3f ms on average, %.3f ms at most, %zu bytes reparsed on average\n",
+           edits, total / edits * 1000, slowest * 1000, reparsed / edits);
+    return 0;
+}
@@ -1,7 +1,13 @@
 #include "datatype.hpp"
 
 // Datatype implementation
-Datatype::Datatype(Type type_value) noexcept : type(type_value) {}
+Datatype::Datatype(Type type_value) noexcept : ASTNodeInterface(NodeKind::DATATYPE), type(type_value) {}
+
+Datatype::~Datatype() noexcept
+{
+    // Types are only destroyed at exit, with the list of each type
+    delete list_of.load(std::memory_order_acquire);
+}
 
 Datatype::Type Datatype::get_type() const noexcept 
 {
@@ -40,11 +46,6 @@ std::string Datatype::to_mikrotik(const std::string& ident) const
 // BasicDatatype implementation
 BasicDatatype::BasicDatatype(Type type_value) noexcept : Datatype(type_value) {}
 
-void BasicDatatype::destroy() noexcept 
-{
-    // No dynamic memory to clean up
-}
-
 std::string BasicDatatype::to_mikrotik(const std::string& ident) const 
 {
     // Return empty string by default
@@ -96,6 +97,39 @@ std::string IPCIDRDatatype::to_mikrotik(const std::string& ident) const
     return "\"0.0.0.0/0\""; // Default CIDR representation
 }
 
+// IPRangeDatatype implementation
+IPRangeDatatype::IPRangeDatatype() noexcept : BasicDatatype(Type::IP_RANGE) {}
+
+std::string IPRangeDatatype::to_mikrotik(const std::string& ident) const 
+{
+    // Ranges are written unquoted in MikroTik
+    return "0.0.0.0-0.0.0.0"; // Default range representation
+}
+
+// IPv6AddressDatatype implementation
+IPv6AddressDatatype::IPv6AddressDatatype() noexcept : BasicDatatype(Type::IPV6_ADDRESS) {}
+
+std::string IPv6AddressDatatype::to_mikrotik(const std::string& ident) const 
+{
+    return "::"; // Default IPv6 address representation
+}
+
+// IPv6CIDRDatatype implementation
+IPv6CIDRDatatype::IPv6CIDRDatatype() noexcept : BasicDatatype(Type::IPV6_CIDR) {}
+
+std::string IPv6CIDRDatatype::to_mikrotik(const std::string& ident) const 
+{
+    return "::/0"; // Default IPv6 CIDR representation
+}
+
+// IPv6RangeDatatype implementation
+IPv6RangeDatatype::IPv6RangeDatatype() noexcept : BasicDatatype(Type::IPV6_RANGE) {}
+
+std::string IPv6RangeDatatype::to_mikrotik(const std::string& ident) const 
+{
+    return "::-::"; // Default IPv6 range representation
+}
+
 // ConfigSectionDatatype implementation
 ConfigSectionDatatype::ConfigSectionDatatype() noexcept : BasicDatatype(Type::SECTION) {}
 
@@ -123,25 +157,67 @@ std::string InterfaceDatatype::to_mikrotik(const std::string& ident) const
 }
 
 // ListDatatype implementation
-ListDatatype::ListDatatype(Datatype* element_type) noexcept 
-    : Datatype(Type::LIST), element_type(element_type) {}
+ListDatatype::ListDatatype(const Datatype& element_type) noexcept 
+    : Datatype(Type::LIST), element_type(&element_type) {}
 
-void ListDatatype::destroy() noexcept 
+const Datatype& ListDatatype::get_element_type() const noexcept 
 {
-    if (element_type) {
-        element_type->destroy();
-        delete element_type;
-        element_type = nullptr;
-    }
+    return *element_type;
 }
 
-Datatype* ListDatatype::get_element_type() const noexcept 
+std::string ListDatatype::type_name() const 
 {
-    return element_type;
+    return "list of " + element_type->type_name();
 }
 
 std::string ListDatatype::to_mikrotik(const std::string& ident) const 
 {
     // In MikroTik, arrays are represented using curly braces
     return "{}"; // Empty array representation
-} 
\ No newline at end of file
+}
+
+// Canonical instances
+const Datatype& basic_datatype(Datatype::Type type) noexcept
+{
+    static const StringDatatype string_type;
+    static const NumberDatatype number_type;
+    static const BooleanDatatype boolean_type;
+    static const IPAddressDatatype ip_address_type;
+    static const IPCIDRDatatype ip_cidr_type;
+    static const IPRangeDatatype ip_range_type;
+    static const IPv6AddressDatatype ipv6_address_type;
+    static const IPv6CIDRDatatype ipv6_cidr_type;
+    static const IPv6RangeDatatype ipv6_range_type;
+    static const ConfigSectionDatatype section_type;
+
+    switch (type) {
+        case Datatype::Type::NUMBER: return number_type;
+        case Datatype::Type::BOOLEAN: return boolean_type;
+        case Datatype::Type::IP_ADDRESS: return ip_address_type;
+        case Datatype::Type::IP_CIDR: return ip_cidr_type;
+        case Datatype::Type::IP_RANGE: return ip_range_type;
+        case Datatype::Type::IPV6_ADDRESS: return ipv6_address_type;
+        case Datatype::Type::IPV6_CIDR: return ipv6_cidr_type;
+        case Datatype::Type::IPV6_RANGE: return ipv6_range_type;
+        case Datatype::Type::SECTION: return section_type;
+        case Datatype::Type::STRING:
+        case Datatype::Type::LIST:
+        default: return string_type;
+    }
+}
+
+const ListDatatype& list_datatype(const Datatype& element_type)
+{
+    const ListDatatype* list = element_type.list_of.load(std::memory_order_acquire);
+    if (list) {
+        return *list;
+    }
+
+    // First list of this type: publish ours, unless another thread won
+    auto* created = new ListDatatype(element_type);
+    if (element_type.list_of.compare_exchange_strong(list, created, std::memory_order_acq_rel)) {
+        return *created;
+    }
+    delete created;
+    return *list;
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
+
 #include "ast_node_interface.hpp"
 
+class ListDatatype;
+
 // Base class for all data types
 class Datatype : public ASTNodeInterface
 {
@@ -22,6 +26,15 @@ public:
     };
 
     Datatype(Type type_value) noexcept;
+    ~Datatype() noexcept override;
+
+    // Types are canonical (see basic_datatype() and list_datatype()): one
+    // instance per type, never copied, so two types are equal if and only
+    // if they are the same object
+    Datatype(const Datatype&) = delete;
+    Datatype& operator=(const Datatype&) = delete;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::DATATYPE; }
     Type get_type() const noexcept;
     
     // Returns a string representation of the type
@@ -31,6 +44,12 @@ public:
 
 protected:
     Type type;
+
+private:
+    friend const ListDatatype& list_datatype(const Datatype& element_type);
+
+    // The list of this type, created by the first list_datatype() for it
+    mutable std::atomic<const ListDatatype*> list_of{nullptr};
 };
 
 // Basic types used in the DSL
@@ -38,7 +57,6 @@ class BasicDatatype : public Datatype
 {
 public:
     BasicDatatype(Type type_value) noexcept;
-    void destroy() noexcept override;
     std::string to_mikrotik(const std::string& ident) const override;
 };
 
@@ -81,6 +99,34 @@ public:
     std::string to_mikrotik(const std::string& ident) const override;
 };
 
+class IPRangeDatatype : public BasicDatatype
+{
+public:
+    IPRangeDatatype() noexcept;
+    std::string to_mikrotik(const std::string& ident) const override;
+};
+
+class IPv6AddressDatatype : public BasicDatatype
+{
+public:
+    IPv6AddressDatatype() noexcept;
+    std::string to_mikrotik(const std::string& ident) const override;
+};
+
+class IPv6CIDRDatatype : public BasicDatatype
+{
+public:
+    IPv6CIDRDatatype() noexcept;
+    std::string to_mikrotik(const std::string& ident) const override;
+};
+
+class IPv6RangeDatatype : public BasicDatatype
+{
+public:
+    IPv6RangeDatatype() noexcept;
+    std::string to_mikrotik(const std::string& ident) const override;
+};
+
 // Config section type (for device, interfaces, firewall sections)
 class ConfigSectionDatatype : public BasicDatatype
 {
@@ -103,11 +149,20 @@ public:
 class ListDatatype : public Datatype
 {
 public:
-    ListDatatype(Datatype* element_type) noexcept;
-    void destroy() noexcept override;
-    Datatype* get_element_type() const noexcept;
+    explicit ListDatatype(const Datatype& element_type) noexcept;
+    const Datatype& get_element_type() const noexcept;
+    std::string type_name() const override;
     std::string to_mikrotik(const std::string& ident) const override;
 
 private:
-    Datatype* element_type; // Type of elements in the list
-}; 
\ No newline at end of file
+    const Datatype* element_type; // Type of elements in the list
+};
+
+// The canonical instance of a basic type (any type but LIST), shared by the
+// whole process. Values return these from get_type(), nothing is allocated.
+const Datatype& basic_datatype(Datatype::Type type) noexcept;
+
+// The canonical list of element_type: allocated by the first call for an
+// element type and kept for the rest of the process (lists of lists too),
+// afterwards a single atomic load. Safe to call from several threads.
+const ListDatatype& list_datatype(const Datatype& element_type);
@@ -3,24 +3,21 @@
 #include <algorithm>
 
 // Declaration implementation
-Declaration::Declaration(std::string_view decl_name) noexcept : name(decl_name) {}
+Declaration::Declaration(NodeKind kind, std::string_view decl_name) noexcept : ASTNodeInterface(kind), name(decl_name) {}
 
-const std::string& Declaration::get_name() const noexcept 
+std::string_view Declaration::get_name() const noexcept 
 {
     return name;
 }
 
 std::string Declaration::to_mikrotik(const std::string& ident) const
 {
-    return ident + "# Declaration: " + name;
+    return ident + "# Declaration: " + std::string(name);
 }
 
 // ConfigDeclaration implementation
-ConfigDeclaration::ConfigDeclaration(std::string_view config_name) noexcept 
-    : Declaration(config_name), statements() {}
-
-ConfigDeclaration::ConfigDeclaration(std::string_view config_name, const StatementList& statements) noexcept 
-    : Declaration(config_name), statements(statements) {}
+ConfigDeclaration::ConfigDeclaration(std::string_view config_name, std::pmr::memory_resource* resource) noexcept 
+    : Declaration(NodeKind::CONFIG_DECLARATION, config_name), statements(resource) {}
 
 void ConfigDeclaration::add_statement(Statement* statement) noexcept 
 {
@@ -34,17 +31,6 @@ const StatementList& ConfigDeclaration::get_statements() const noexcept
     return statements;
 }
 
-void ConfigDeclaration::destroy() noexcept 
-{
-    for (auto* statement : statements) {
-        if (statement) {
-            statement->destroy();
-            delete statement;
-        }
-    }
-    statements.clear();
-}
-
 std::string ConfigDeclaration::to_string() const 
 {
     std::stringstream ss;
@@ -68,7 +54,7 @@ std::string ConfigDeclaration::to_mikrotik(const std::string& ident) const
     std::string menu_path;
     
     // Convert name to lowercase for case-insensitive comparison
-    std::string lower_name = name;
+    std::string lower_name(name);
     std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
     
     // Skip device/vendor/model processing - this is already handled by SectionStatement
@@ -168,23 +154,17 @@ std::string ConfigDeclaration::to_mikrotik(const std::string& ident) const
         // Find vendor and model properties
         for (const auto* statement : statements) {
             if (statement) {
-                if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(statement)) {
-                    const std::string& prop_name = prop_stmt->get_name();
-                    if (prop_name == "vendor") {
+                if (const auto* prop_stmt = node_cast<PropertyStatement>(statement)) {
+                    Symbol prop_symbol = prop_stmt->get_symbol();
+                    if (prop_symbol == Symbol::VENDOR) {
                         if (prop_stmt->get_value()) {
-                            vendor_value = prop_stmt->get_value()->to_mikrotik("");
-                            // Remove quotes if present
-                            if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                                vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                            }
+                            std::string storage;
+                            vendor_value = value_text(prop_stmt->get_value(), storage);
                         }
-                    } else if (prop_name == "model") {
+                    } else if (prop_symbol == Symbol::MODEL) {
                         if (prop_stmt->get_value()) {
-                            model_value = prop_stmt->get_value()->to_mikrotik("");
-                            // Remove quotes if present
-                            if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                                model_value = model_value.substr(1, model_value.size() - 2);
-                            }
+                            std::string storage;
+                            model_value = value_text(prop_stmt->get_value(), storage);
                         }
                     }
                 } else {
@@ -198,25 +178,10 @@ std::string ConfigDeclaration::to_mikrotik(const std::string& ident) const
         if (!vendor_value.empty() || !model_value.empty()) {
             std::string device_name;
             if (!vendor_value.empty() && !model_value.empty()) {
-                // Remove quotes if present in both values
-                if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                    vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                }
-                if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                    model_value = model_value.substr(1, model_value.size() - 2);
-                }
                 device_name = vendor_value + "_" + model_value;
             } else if (!vendor_value.empty()) {
-                // Remove quotes if present
-                if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                    vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                }
                 device_name = vendor_value;
             } else {
-                // Remove quotes if present
-                if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                    model_value = model_value.substr(1, model_value.size() - 2);
-                }
                 device_name = model_value;
             }
             
@@ -237,10 +202,10 @@ std::string ConfigDeclaration::to_mikrotik(const std::string& ident) const
     // Process all statements within this configuration block to gather parameters
     for (const auto* statement : statements) {
         if (statement) {
-            if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(statement)) {
+            if (const auto* prop_stmt = node_cast<PropertyStatement>(statement)) {
                 // For property statements, extract the name=value pair
                 property_params.push_back(prop_stmt->to_mikrotik(""));
-            } else if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(statement)) {
+            } else if (const auto* prop_stmt = node_cast<PropertyStatement>(statement)) {
                 // For property declarations, extract the name=value pair
                 std::string prop_value = prop_stmt->to_mikrotik("");
                 // If to_mikrotik returns a full command like "set name=value\n", extract just the parameter
@@ -314,7 +279,7 @@ std::string ConfigDeclaration::determine_action(const std::string& menu_path) co
     }
     
     // Check for any specific config name indicators
-    std::string lower_name = name;
+    std::string lower_name(name);
     std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
     
     if (lower_name.find("add") != std::string::npos) {
@@ -332,42 +297,52 @@ std::string ConfigDeclaration::determine_action(const std::string& menu_path) co
 }
 
 // ProgramDeclaration implementation
-ProgramDeclaration::ProgramDeclaration() noexcept 
-    : Declaration("program"), sections() {}
+ProgramDeclaration::ProgramDeclaration(std::pmr::memory_resource* resource) noexcept 
+    : Declaration(NodeKind::PROGRAM_DECLARATION, "program"), sections(resource), section_modules(resource) {}
 
-void ProgramDeclaration::add_section(SectionStatement* section) noexcept 
+void ProgramDeclaration::add_section(SectionStatement* section)
 {
     if (section) {
-        
-        
         sections.push_back(section);
+        section_modules.push_back(nullptr);
         
-        // Set parent for any sub-sections in the block
-        if (section->get_block()) {
-            for (auto* stmt : section->get_block()->get_statements()) {
-                if (auto* sub_section = dynamic_cast<SectionStatement*>(stmt)) {
+        // Set the parent of the sub-sections at every depth
+        section->link_subsections(sections.get_allocator().resource());
+    }
+}
 
-                    sub_section->set_parent(section);
-                }
-            }
-        }
+void ProgramDeclaration::add_imported_section(SectionStatement* section, const Module* module) noexcept
+{
+    // Parents were set when the module was parsed
+    if (section) {
+        sections.push_back(section);
+        section_modules.push_back(module);
     }
 }
 
-const std::vector<SectionStatement*>& ProgramDeclaration::get_sections() const noexcept 
+void ProgramDeclaration::clear_sections() noexcept
+{
+    sections.clear();
+    section_modules.clear();
+}
+
+void ProgramDeclaration::replace_sections(size_t index, size_t count,
+                                          const std::vector<SectionStatement*>& replacement)
+{
+    sections.erase(sections.begin() + index, sections.begin() + index + count);
+    sections.insert(sections.begin() + index, replacement.begin(), replacement.end());
+    section_modules.erase(section_modules.begin() + index, section_modules.begin() + index + count);
+    section_modules.insert(section_modules.begin() + index, replacement.size(), nullptr);
+}
+
+const std::pmr::vector<SectionStatement*>& ProgramDeclaration::get_sections() const noexcept 
 {
     return sections;
 }
 
-void ProgramDeclaration::destroy() noexcept 
+const Module* ProgramDeclaration::get_section_module(size_t index) const noexcept
 {
-    for (auto* section : sections) {
-        if (section) {
-            section->destroy();
-            delete section;
-        }
-    }
-    sections.clear();
+    return index < section_modules.size() ? section_modules[index] : nullptr;
 }
 
 std::string ProgramDeclaration::to_string() const 
@@ -384,15 +359,18 @@ std::string ProgramDeclaration::to_string() const
 std::string ProgramDeclaration::to_mikrotik(const std::string& ident) const
 {
     std::stringstream ss;
-    
-    
-    // Process all top-level sections
+    write_mikrotik(ss, ident);
+    return ss.str();
+}
+
+void ProgramDeclaration::write_mikrotik(std::ostream& out, const std::string& ident) const
+{
+    // Process all top-level sections, each one is handed to out (and flushed)
+    // as soon as it is generated
     for (const auto* section : sections) {
         if (section) {
-            ss << section->to_mikrotik(ident + "    ");
+            out << section->to_mikrotik(ident + "    ");
+            out.flush();
         }
     }
-    
-    
-    return ss.str();
-} 
\ No newline at end of file
+}
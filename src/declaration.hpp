@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -9,31 +10,40 @@
 #include "ast_node_interface.hpp"
 #include "statement.hpp"
 
+struct Module;
+
 // Base class for declarations
 class Declaration : public ASTNodeInterface
 {
 public:
-    Declaration(std::string_view decl_name) noexcept;
+    Declaration(NodeKind kind, std::string_view decl_name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::CONFIG_DECLARATION, NodeKind::PROGRAM_DECLARATION);
+    }
     
-    const std::string& get_name() const noexcept;
+    // The name references the source text or a literal, it is not copied
+    std::string_view get_name() const noexcept;
     std::string to_mikrotik(const std::string& ident) const override;
     
 protected:
-    std::string name;
+    std::string_view name;
 };
 
 // Declaration for a configuration section
 class ConfigDeclaration : public Declaration
 {
 public:
-    ConfigDeclaration(std::string_view config_name) noexcept;
-    ConfigDeclaration(std::string_view config_name, const StatementList& statements) noexcept;
+    // The statement list is allocated from resource (the AstArena)
+    ConfigDeclaration(std::string_view config_name, std::pmr::memory_resource* resource) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::CONFIG_DECLARATION; }
     
     // Add a statement to this configuration
     void add_statement(Statement* statement) noexcept;
     
     const StatementList& get_statements() const noexcept;
-    void destroy() noexcept override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
@@ -48,16 +58,37 @@ private:
 class ProgramDeclaration : public Declaration
 {
 public:
-    ProgramDeclaration() noexcept;
+    // The section list is allocated from resource (the AstArena)
+    explicit ProgramDeclaration(std::pmr::memory_resource* resource) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::PROGRAM_DECLARATION; }
     
     // Add a section to this program
-    void add_section(SectionStatement* section) noexcept;
+    void add_section(SectionStatement* section);
+
+    // Add a section of an imported module. The section is shared with the
+    // module (and every other program importing it), it is not modified.
+    // Also used to gather the sections of other programs (module nullptr).
+    void add_imported_section(SectionStatement* section, const Module* module) noexcept;
+
+    void clear_sections() noexcept;
+
+    // Replaces count sections from index with sections of other programs
+    // (not imported ones), as add_imported_section
+    void replace_sections(size_t index, size_t count, const std::vector<SectionStatement*>& replacement);
     
-    const std::vector<SectionStatement*>& get_sections() const noexcept;
-    void destroy() noexcept override;
+    const std::pmr::vector<SectionStatement*>& get_sections() const noexcept;
+
+    // Module the section at index was imported from, nullptr for the
+    // program's own sections
+    const Module* get_section_module(size_t index) const noexcept;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
+
+    // Same as to_mikrotik, streamed section by section
+    void write_mikrotik(std::ostream& out, const std::string& ident) const;
     
 private:
-    std::vector<SectionStatement*> sections;
+    std::pmr::vector<SectionStatement*> sections;
+    std::pmr::vector<const Module*> section_modules;  // Parallel to sections
 }; 
\ No newline at end of file
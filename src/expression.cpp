@@ -1,19 +1,19 @@
 #include "expression.hpp"
+#include <algorithm>
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
+
+Expression::Expression(NodeKind kind) noexcept : ASTNodeInterface(kind) {}
 
 // Value implementation
-Value::Value(ValueType val_type) noexcept : value_type(val_type) {}
+Value::Value(NodeKind kind, ValueType val_type) noexcept : Expression(kind), value_type(val_type) {}
 
 Value::ValueType Value::get_value_type() const noexcept 
 {
     return value_type;
 }
 
-void Value::destroy() noexcept 
-{
-    // No dynamic memory to clean up
-}
-
 std::string Value::to_mikrotik(const std::string& ident) const
 {
     // Default implementation returns a comment
@@ -21,42 +21,110 @@ std::string Value::to_mikrotik(const std::string& ident) const
 }
 
 // StringValue implementation
-StringValue::StringValue(std::string_view str_value) noexcept 
-    : Value(ValueType::STRING), str_value(str_value) {}
+StringValue::StringValue(std::string_view literal, bool quoted) noexcept 
+    : Value(NodeKind::STRING_VALUE, ValueType::STRING), literal(literal), quoted(quoted) {}
 
-const std::string& StringValue::get_value() const noexcept 
+std::string_view StringValue::get_value() const noexcept 
 {
-    return str_value;
+    return quoted ? literal.substr(1, literal.size() - 2) : literal;
 }
 
-Datatype* StringValue::get_type() const 
+std::string_view StringValue::get_literal() const noexcept 
 {
-    return new StringDatatype();
+    return literal;
+}
+
+bool StringValue::is_quoted() const noexcept 
+{
+    return quoted;
+}
+
+// Characters a RouterOS script reads specially inside a quoted string
+static bool needs_routeros_escape(char c) noexcept
+{
+    return c == '\\' || c == '"' || c == '$' || c == '?' || static_cast<unsigned char>(c) < 0x20;
+}
+
+// The quoted, escaped text of value, stored once per process however many
+// literals (and compilations) spell it, so that the nodes can keep a
+// pointer to it. Safe to call from several threads at once.
+static const std::string* intern_routeros_literal(std::string_view value)
+{
+    static const char hex_digits[] = "0123456789ABCDEF";
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (!needs_routeros_escape(c)) {
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if (c == '\r') {
+            escaped += "\\r";
+        } else if (c == '\t') {
+            escaped += "\\t";
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += '\\';
+            escaped += hex_digits[static_cast<unsigned char>(c) >> 4];
+            escaped += hex_digits[c & 0xF];
+        } else {
+            escaped += '\\';
+            escaped += c;
+        }
+    }
+    escaped += '"';
+
+    static std::mutex mutex;
+    static std::unordered_set<std::string> literals;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*literals.insert(std::move(escaped)).first;
+}
+
+std::string_view StringValue::get_routeros_text() const
+{
+    // Marks a literal that is written as it is in the source
+    static const std::string no_escapes;
+
+    if (!quoted) {
+        return literal;
+    }
+    const std::string* text = routeros_text.load(std::memory_order_acquire);
+    if (text == nullptr) {
+        // Threads that get here at once store the same result
+        std::string_view value = get_value();
+        bool plain = std::none_of(value.begin(), value.end(), needs_routeros_escape);
+        text = plain ? &no_escapes : intern_routeros_literal(value);
+        routeros_text.store(text, std::memory_order_release);
+    }
+    return text == &no_escapes ? literal : std::string_view(*text);
+}
+
+const Datatype& StringValue::get_type() const 
+{
+    return basic_datatype(Datatype::Type::STRING);
 }
 
 std::string StringValue::to_string() const 
 {
-    return "\"" + str_value + "\"";
+    return "\"" + std::string(get_value()) + "\"";
 }
 
 std::string StringValue::to_mikrotik(const std::string& ident) const
 {
-    // Return the string value without quotes (quotes will be added where needed)
-    return str_value;
+    // Keywords are written bare, literals in quotes and escaped
+    return std::string(get_routeros_text());
 }
 
 // NumberValue implementation
 NumberValue::NumberValue(int num_value) noexcept 
-    : Value(ValueType::NUMBER), num_value(num_value) {}
+    : Value(NodeKind::NUMBER_VALUE, ValueType::NUMBER), num_value(num_value) {}
 
 int NumberValue::get_value() const noexcept 
 {
     return num_value;
 }
 
-Datatype* NumberValue::get_type() const 
+const Datatype& NumberValue::get_type() const 
 {
-    return new NumberDatatype();
+    return basic_datatype(Datatype::Type::NUMBER);
 }
 
 std::string NumberValue::to_string() const 
@@ -72,16 +140,16 @@ std::string NumberValue::to_mikrotik(const std::string& ident) const
 
 // BooleanValue implementation
 BooleanValue::BooleanValue(bool bool_value) noexcept 
-    : Value(ValueType::BOOLEAN), bool_value(bool_value) {}
+    : Value(NodeKind::BOOLEAN_VALUE, ValueType::BOOLEAN), bool_value(bool_value) {}
 
 bool BooleanValue::get_value() const noexcept 
 {
     return bool_value;
 }
 
-Datatype* BooleanValue::get_type() const 
+const Datatype& BooleanValue::get_type() const 
 {
-    return new BooleanDatatype();
+    return basic_datatype(Datatype::Type::BOOLEAN);
 }
 
 std::string BooleanValue::to_string() const 
@@ -96,95 +164,194 @@ std::string BooleanValue::to_mikrotik(const std::string& ident) const
 }
 
 // IPAddressValue implementation
-IPAddressValue::IPAddressValue(std::string_view ip_value) noexcept 
-    : Value(ValueType::IP_ADDRESS), ip_value(ip_value) {}
+IPAddressValue::IPAddressValue(uint32_t address) noexcept 
+    : Value(NodeKind::IP_ADDRESS_VALUE, ValueType::IP_ADDRESS), address(address) {}
 
-const std::string& IPAddressValue::get_value() const noexcept 
+uint32_t IPAddressValue::get_address() const noexcept 
 {
-    return ip_value;
+    return address;
 }
 
-Datatype* IPAddressValue::get_type() const 
+const Datatype& IPAddressValue::get_type() const 
 {
-    return new IPAddressDatatype();
+    return basic_datatype(Datatype::Type::IP_ADDRESS);
 }
 
 std::string IPAddressValue::to_string() const 
 {
-    return ip_value;
+    return format_ipv4(address);
 }
 
 std::string IPAddressValue::to_mikrotik(const std::string& ident) const
 {
     // IP addresses in MikroTik can be represented in quotes or directly
-    return "\"" + ip_value + "\"";
+    return "\"" + format_ipv4(address) + "\"";
 }
 
 // IPCIDRValue implementation
-IPCIDRValue::IPCIDRValue(std::string_view cidr_value) noexcept 
-    : Value(ValueType::IP_CIDR), cidr_value(cidr_value) {}
+IPCIDRValue::IPCIDRValue(const IPv4Prefix& prefix) noexcept 
+    : Value(NodeKind::IP_CIDR_VALUE, ValueType::IP_CIDR), prefix(prefix) {}
+
+const IPv4Prefix& IPCIDRValue::get_prefix() const noexcept 
+{
+    return prefix;
+}
 
-const std::string& IPCIDRValue::get_value() const noexcept 
+uint32_t IPCIDRValue::get_address() const noexcept 
 {
-    return cidr_value;
+    return prefix.address;
 }
 
-Datatype* IPCIDRValue::get_type() const 
+int IPCIDRValue::get_prefix_length() const noexcept 
 {
-    return new IPCIDRDatatype();
+    return prefix.length;
+}
+
+const Datatype& IPCIDRValue::get_type() const 
+{
+    return basic_datatype(Datatype::Type::IP_CIDR);
 }
 
 std::string IPCIDRValue::to_string() const 
 {
-    return cidr_value;
+    return format_ipv4_prefix(prefix);
 }
 
 std::string IPCIDRValue::to_mikrotik(const std::string& ident) const
 {
     // CIDR notation in MikroTik can be represented in quotes or directly
-    return "\"" + cidr_value + "\"";
+    return "\"" + format_ipv4_prefix(prefix) + "\"";
 }
 
-// ListValue implementation
-ListValue::ListValue(const ValueList& values, Datatype* element_type) noexcept 
-    : values(values), element_type(element_type) {}
+// IPRangeValue implementation
+IPRangeValue::IPRangeValue(const IPv4Range& range) noexcept 
+    : Value(NodeKind::IP_RANGE_VALUE, ValueType::IP_RANGE), range(range) {}
 
-const ValueList& ListValue::get_values() const noexcept 
+const IPv4Range& IPRangeValue::get_range() const noexcept 
 {
-    return values;
+    return range;
 }
 
-void ListValue::destroy() noexcept 
+const Datatype& IPRangeValue::get_type() const 
 {
-    for (auto* value : values) {
-        if (value) {
-            value->destroy();
-            delete value;
-        }
-    }
-    values.clear();
-    
-    if (element_type) {
-        element_type->destroy();
-        delete element_type;
-        element_type = nullptr;
-    }
+    return basic_datatype(Datatype::Type::IP_RANGE);
+}
+
+std::string IPRangeValue::to_string() const 
+{
+    return format_ipv4_range(range);
 }
 
-Datatype* ListValue::get_type() const 
+std::string IPRangeValue::to_mikrotik(const std::string& ident) const
+{
+    // Ranges are written unquoted, as in pools (ranges=10.0.0.10-10.0.0.20)
+    return format_ipv4_range(range);
+}
+
+// IPv6AddressValue implementation
+IPv6AddressValue::IPv6AddressValue(const IPv6Address& address) noexcept 
+    : Value(NodeKind::IPV6_ADDRESS_VALUE, ValueType::IPV6_ADDRESS), address(address) {}
+
+const IPv6Address& IPv6AddressValue::get_address() const noexcept 
+{
+    return address;
+}
+
+const Datatype& IPv6AddressValue::get_type() const 
+{
+    return basic_datatype(Datatype::Type::IPV6_ADDRESS);
+}
+
+std::string IPv6AddressValue::to_string() const 
+{
+    return format_ipv6(address);
+}
+
+std::string IPv6AddressValue::to_mikrotik(const std::string& ident) const
+{
+    // IPv6 addresses are written unquoted, in canonical (RFC 5952) form
+    return format_ipv6(address);
+}
+
+// IPv6CIDRValue implementation
+IPv6CIDRValue::IPv6CIDRValue(const IPv6Prefix& prefix) noexcept 
+    : Value(NodeKind::IPV6_CIDR_VALUE, ValueType::IPV6_CIDR), prefix(prefix) {}
+
+const IPv6Prefix& IPv6CIDRValue::get_prefix() const noexcept 
+{
+    return prefix;
+}
+
+const IPv6Address& IPv6CIDRValue::get_address() const noexcept 
+{
+    return prefix.address;
+}
+
+int IPv6CIDRValue::get_prefix_length() const noexcept 
+{
+    return prefix.length;
+}
+
+const Datatype& IPv6CIDRValue::get_type() const 
+{
+    return basic_datatype(Datatype::Type::IPV6_CIDR);
+}
+
+std::string IPv6CIDRValue::to_string() const 
+{
+    return format_ipv6_prefix(prefix);
+}
+
+std::string IPv6CIDRValue::to_mikrotik(const std::string& ident) const
+{
+    return format_ipv6_prefix(prefix);
+}
+
+// IPv6RangeValue implementation
+IPv6RangeValue::IPv6RangeValue(const IPv6Range& range) noexcept 
+    : Value(NodeKind::IPV6_RANGE_VALUE, ValueType::IPV6_RANGE), range(range) {}
+
+const IPv6Range& IPv6RangeValue::get_range() const noexcept 
+{
+    return range;
+}
+
+const Datatype& IPv6RangeValue::get_type() const 
+{
+    return basic_datatype(Datatype::Type::IPV6_RANGE);
+}
+
+std::string IPv6RangeValue::to_string() const 
+{
+    return format_ipv6_range(range);
+}
+
+std::string IPv6RangeValue::to_mikrotik(const std::string& ident) const
+{
+    return format_ipv6_range(range);
+}
+
+// ListValue implementation
+ListValue::ListValue(ValueList&& values, const Datatype* element_type) noexcept 
+    : Expression(NodeKind::LIST_VALUE), values(std::move(values)), element_type(element_type) {}
+
+const ValueList& ListValue::get_values() const noexcept 
+{
+    return values;
+}
+
+const Datatype& ListValue::get_type() const 
 {
     // If we have an element type, use it; otherwise try to determine from first element
     if (element_type) {
-        return new ListDatatype(element_type->get_type() == Datatype::Type::LIST 
-            ? new ListDatatype(static_cast<ListDatatype*>(element_type)->get_element_type())
-            : element_type);
+        return list_datatype(*element_type);
     }
     else if (!values.empty() && values[0]) {
-        return new ListDatatype(values[0]->get_type());
+        return list_datatype(values[0]->get_type());
     }
     
     // Default to list of strings if we can't determine
-    return new ListDatatype(new StringDatatype());
+    return list_datatype(basic_datatype(Datatype::Type::STRING));
 }
 
 std::string ListValue::to_string() const 
@@ -235,41 +402,36 @@ std::string ListValue::to_mikrotik(const std::string& ident) const
 
 // IdentifierExpression implementation
 IdentifierExpression::IdentifierExpression(std::string_view name) noexcept 
-    : name(name) {}
+    : Expression(NodeKind::IDENTIFIER_EXPRESSION), name(name) {}
 
-const std::string& IdentifierExpression::get_name() const noexcept 
+std::string_view IdentifierExpression::get_name() const noexcept 
 {
     return name;
 }
 
-void IdentifierExpression::destroy() noexcept 
-{
-    // No dynamic memory to clean up
-}
-
-Datatype* IdentifierExpression::get_type() const 
+const Datatype& IdentifierExpression::get_type() const 
 {
     // This would typically be resolved during semantic analysis
     // Default to string type for now
-    return new StringDatatype();
+    return basic_datatype(Datatype::Type::STRING);
 }
 
 std::string IdentifierExpression::to_string() const 
 {
-    return name;
+    return std::string(name);
 }
 
 std::string IdentifierExpression::to_mikrotik(const std::string& ident) const
 {
     // In MikroTik, variables are prefixed with $
-    return "$" + name;
+    return "$" + std::string(name);
 }
 
 // PropertyReference implementation
 PropertyReference::PropertyReference(Expression* base, std::string_view property_name) noexcept 
-    : base(base), property_name(property_name) {}
+    : Expression(NodeKind::PROPERTY_REFERENCE), base(base), property_name(property_name) {}
 
-const std::string& PropertyReference::get_property_name() const noexcept 
+std::string_view PropertyReference::get_property_name() const noexcept 
 {
     return property_name;
 }
@@ -279,32 +441,43 @@ Expression* PropertyReference::get_base() const noexcept
     return base;
 }
 
-void PropertyReference::destroy() noexcept 
-{
-    if (base) {
-        base->destroy();
-        delete base;
-        base = nullptr;
-    }
-}
-
-Datatype* PropertyReference::get_type() const 
+const Datatype& PropertyReference::get_type() const 
 {
     // This would typically be resolved during semantic analysis
     // Default to string type for now
-    return new StringDatatype();
+    return basic_datatype(Datatype::Type::STRING);
 }
 
 std::string PropertyReference::to_string() const 
 {
-    return base ? base->to_string() + "." + property_name : property_name;
+    std::string name(property_name);
+    return base ? base->to_string() + "." + name : name;
 }
 
 std::string PropertyReference::to_mikrotik(const std::string& ident) const
 {
     // In MikroTik, property access uses the -> operator
+    std::string name(property_name);
     if (base) {
-        return "(" + base->to_mikrotik("") + "->" + property_name + ")";
+        return "(" + base->to_mikrotik("") + "->" + name + ")";
     }
-    return "$" + property_name;
-} 
\ No newline at end of file
+    return "$" + name;
+} 
+
+std::string_view value_text(const Expression* value, std::string& storage)
+{
+    // Strings and IPv4 addresses are the values to_mikrotik() quotes
+    if (const auto* string = node_cast<StringValue>(value)) {
+        return string->get_value();
+    }
+    if (const auto* address = node_cast<IPAddressValue>(value)) {
+        storage = format_ipv4(address->get_address());
+    } else if (const auto* prefix = node_cast<IPCIDRValue>(value)) {
+        storage = format_ipv4_prefix(prefix->get_prefix());
+    } else if (value) {
+        storage = value->to_mikrotik("");
+    } else {
+        storage.clear();
+    }
+    return storage;
+}
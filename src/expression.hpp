@@ -1,14 +1,27 @@
 #pragma once
 
+#include <atomic>
+#include <string>
+#include <string_view>
+
 #include "ast_node_interface.hpp"
 #include "datatype.hpp"
+#include "ip_literal.hpp"
 
 // Base class for all expressions
 class Expression : public ASTNodeInterface
 {
 public:
-    // Get the data type of this expression
-    virtual Datatype* get_type() const = 0;
+    explicit Expression(NodeKind kind) noexcept;
+
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::STRING_VALUE, NodeKind::PROPERTY_REFERENCE);
+    }
+
+    // Get the data type of this expression (a canonical instance, see
+    // basic_datatype(); nothing is allocated)
+    virtual const Datatype& get_type() const = 0;
 };
 
 // Base class for values (literals)
@@ -27,10 +40,14 @@ public:
         IPV6_RANGE
     };
 
-    Value(ValueType val_type) noexcept;
+    Value(NodeKind kind, ValueType val_type) noexcept;
+
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::STRING_VALUE, NodeKind::IPV6_RANGE_VALUE);
+    }
     ValueType get_value_type() const noexcept;
     
-    void destroy() noexcept override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 protected:
@@ -41,15 +58,36 @@ protected:
 class StringValue : public Value
 {
 public:
-    StringValue(std::string_view str_value) noexcept;
+    // literal is the string as written: in quotes if quoted (a string
+    // literal), bare for a keyword (enabled, accept, ...), which
+    // to_mikrotik() writes back without quotes
+    StringValue(std::string_view literal, bool quoted = false) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::STRING_VALUE; }
     
-    const std::string& get_value() const noexcept;
-    Datatype* get_type() const override;
+    // The string without its quotes. It references the source text (see
+    // ParserContext), it is not copied.
+    std::string_view get_value() const noexcept;
+    // The string as written, quotes included if it had them
+    std::string_view get_literal() const noexcept;
+    bool is_quoted() const noexcept;
+    // The string as a RouterOS script reads it: a literal in quotes with
+    // \ " $ ? and control characters escaped, a keyword bare. Worked out on
+    // first use and kept: a literal with nothing to escape is its own
+    // source text, an escaped one is stored once per process.
+    std::string_view get_routeros_text() const;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
+    // get_routeros_text()
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
-    std::string str_value;
+    std::string_view literal;
+    bool quoted;
+    // What get_routeros_text() worked out: null until its first call, then
+    // the escaped text or a marker for a literal that needs no escaping.
+    // Atomic, as the ASTs of imported modules are shared by threads.
+    mutable std::atomic<const std::string*> routeros_text{nullptr};
 };
 
 // Numeric literal value
@@ -57,9 +95,11 @@ class NumberValue : public Value
 {
 public:
     NumberValue(int num_value) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::NUMBER_VALUE; }
     
     int get_value() const noexcept;
-    Datatype* get_type() const override;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
@@ -72,9 +112,11 @@ class BooleanValue : public Value
 {
 public:
     BooleanValue(bool bool_value) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::BOOLEAN_VALUE; }
     
     bool get_value() const noexcept;
-    Datatype* get_type() const override;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
@@ -82,51 +124,131 @@ private:
     bool bool_value;
 };
 
-// IP address value
+// IP address value, decoded by the scanner (host byte order)
 class IPAddressValue : public Value
 {
 public:
-    IPAddressValue(std::string_view ip_value) noexcept;
+    IPAddressValue(uint32_t address) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IP_ADDRESS_VALUE; }
     
-    const std::string& get_value() const noexcept;
-    Datatype* get_type() const override;
+    uint32_t get_address() const noexcept;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
-    std::string ip_value;
+    uint32_t address;
 };
 
 // IP CIDR value (e.g., 192.168.1.0/24)
+// The address keeps its host bits, "192.168.1.1/24" is an interface address
 class IPCIDRValue : public Value
 {
 public:
-    IPCIDRValue(std::string_view cidr_value) noexcept;
+    IPCIDRValue(const IPv4Prefix& prefix) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IP_CIDR_VALUE; }
     
-    const std::string& get_value() const noexcept;
-    Datatype* get_type() const override;
+    const IPv4Prefix& get_prefix() const noexcept;
+    uint32_t get_address() const noexcept;
+    int get_prefix_length() const noexcept;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
-    std::string cidr_value;
+    IPv4Prefix prefix;
+};
+
+// IP range value (e.g., 192.168.1.10-192.168.1.20)
+class IPRangeValue : public Value
+{
+public:
+    IPRangeValue(const IPv4Range& range) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IP_RANGE_VALUE; }
+    
+    const IPv4Range& get_range() const noexcept;
+    const Datatype& get_type() const override;
+    std::string to_string() const override;
+    std::string to_mikrotik(const std::string& ident) const override;
+    
+private:
+    IPv4Range range;
+};
+
+// IPv6 address value, decoded by the scanner
+class IPv6AddressValue : public Value
+{
+public:
+    IPv6AddressValue(const IPv6Address& address) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IPV6_ADDRESS_VALUE; }
+    
+    const IPv6Address& get_address() const noexcept;
+    const Datatype& get_type() const override;
+    std::string to_string() const override;
+    std::string to_mikrotik(const std::string& ident) const override;
+    
+private:
+    IPv6Address address;
+};
+
+// IPv6 CIDR value (e.g., 2001:db8::/32)
+class IPv6CIDRValue : public Value
+{
+public:
+    IPv6CIDRValue(const IPv6Prefix& prefix) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IPV6_CIDR_VALUE; }
+    
+    const IPv6Prefix& get_prefix() const noexcept;
+    const IPv6Address& get_address() const noexcept;
+    int get_prefix_length() const noexcept;
+    const Datatype& get_type() const override;
+    std::string to_string() const override;
+    std::string to_mikrotik(const std::string& ident) const override;
+    
+private:
+    IPv6Prefix prefix;
+};
+
+// IPv6 range value (e.g., 2001:db8::10-2001:db8::20)
+class IPv6RangeValue : public Value
+{
+public:
+    IPv6RangeValue(const IPv6Range& range) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IPV6_RANGE_VALUE; }
+    
+    const IPv6Range& get_range() const noexcept;
+    const Datatype& get_type() const override;
+    std::string to_string() const override;
+    std::string to_mikrotik(const std::string& ident) const override;
+    
+private:
+    IPv6Range range;
 };
 
 // List of values
 class ListValue : public Expression
 {
 public:
-    ListValue(const ValueList& values, Datatype* element_type = nullptr) noexcept;
+    // Takes over the elements of a list built by the parser (and its
+    // allocator, the AstArena); element_type is a canonical type, if given
+    ListValue(ValueList&& values, const Datatype* element_type = nullptr) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::LIST_VALUE; }
     
     const ValueList& get_values() const noexcept;
-    void destroy() noexcept override;
-    Datatype* get_type() const override;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
     ValueList values;
-    Datatype* element_type;
+    const Datatype* element_type;
 };
 
 // Identifier reference
@@ -134,15 +256,17 @@ class IdentifierExpression : public Expression
 {
 public:
     IdentifierExpression(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IDENTIFIER_EXPRESSION; }
     
-    const std::string& get_name() const noexcept;
-    void destroy() noexcept override;
-    Datatype* get_type() const override;
+    // The name references the source text, it is not copied
+    std::string_view get_name() const noexcept;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
-    std::string name;
+    std::string_view name;
 };
 
 // Property reference (identifier.property)
@@ -150,15 +274,23 @@ class PropertyReference : public Expression
 {
 public:
     PropertyReference(Expression* base, std::string_view property_name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::PROPERTY_REFERENCE; }
     
-    const std::string& get_property_name() const noexcept;
+    // The name references the source text, it is not copied
+    std::string_view get_property_name() const noexcept;
     Expression* get_base() const noexcept;
-    void destroy() noexcept override;
-    Datatype* get_type() const override;
+    const Datatype& get_type() const override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
     Expression* base;
-    std::string property_name;
-}; 
\ No newline at end of file
+    std::string_view property_name;
+}; 
+
+// Text of a property value for the generators: what to_mikrotik() writes,
+// without the quotes it puts around strings and IPv4 addresses. Strings are
+// views of the AST; IPv4 literals are formatted (and other values written)
+// into storage, which the result then references. Empty for a null value.
+std::string_view value_text(const Expression* value, std::string& storage);
@@ -0,0 +1,285 @@
+#include "flat_ast.hpp"
+
+#include <string.h>
+#include <unordered_map>
+
+#include "node_visitor.hpp"
+
+// Appends the nodes of a program in source order, a node before its children
+class FlatAst::Builder
+{
+public:
+    explicit Builder(FlatAst& ast) : ast(ast)
+    {
+        ast.texts.push_back(TextRange{0, 0});
+    }
+
+    void add(const ASTNodeInterface* node)
+    {
+        if (node == nullptr) {
+            return;
+        }
+        Index index = static_cast<Index>(ast.kinds.size());
+        ast.kinds.push_back(node->get_kind());
+        ast.spans.push_back(node->get_span());
+        ast.ends.push_back(index + 1);
+        ast.symbols.push_back(Symbol::NONE);
+        ast.text_ids.push_back(0);
+        ast.payloads.push_back(0);
+        visit_node(*node, [this, index](const auto& concrete) { fill(index, concrete); });
+        ast.ends[index] = static_cast<Index>(ast.kinds.size());
+    }
+
+private:
+    void fill(Index index, const ProgramDeclaration& program)
+    {
+        for (const SectionStatement* section : program.get_sections()) {
+            add(section);
+        }
+    }
+
+    // Every specialized section, by its name and section type
+    void fill(Index index, const SectionStatement& section)
+    {
+        ast.symbols[index] = section.get_symbol();
+        set_text(index, section.get_name());
+        ast.payloads[index] = static_cast<uint32_t>(section.get_section_type());
+        add(section.get_block());
+    }
+
+    void fill(Index index, const BlockStatement& block)
+    {
+        for (const Statement* statement : block.get_statements()) {
+            add(statement);
+        }
+    }
+
+    void fill(Index index, const PropertyStatement& property)
+    {
+        ast.symbols[index] = property.get_symbol();
+        set_text(index, property.get_name());
+        add(property.get_value());
+    }
+
+    void fill(Index index, const DeclarationStatement& statement)
+    {
+        add(statement.get_declaration());
+    }
+
+    void fill(Index index, const ConfigDeclaration& config)
+    {
+        set_text(index, config.get_name());
+        for (const Statement* statement : config.get_statements()) {
+            add(statement);
+        }
+    }
+
+    void fill(Index index, const ListValue& list)
+    {
+        for (const Value* value : list.get_values()) {
+            add(value);
+        }
+    }
+
+    void fill(Index index, const IdentifierExpression& identifier)
+    {
+        set_text(index, identifier.get_name());
+    }
+
+    void fill(Index index, const PropertyReference& reference)
+    {
+        set_text(index, reference.get_property_name());
+        add(reference.get_base());
+    }
+
+    void fill(Index index, const StringValue& value)
+    {
+        set_text(index, value.get_value());
+        ast.payloads[index] = value.is_quoted() ? 1 : 0;
+    }
+
+    void fill(Index index, const NumberValue& value)
+    {
+        ast.payloads[index] = static_cast<uint32_t>(value.get_value());
+    }
+
+    void fill(Index index, const BooleanValue& value)
+    {
+        ast.payloads[index] = value.get_value() ? 1 : 0;
+    }
+
+    void fill(Index index, const IPAddressValue& value)
+    {
+        ast.payloads[index] = value.get_address();
+    }
+
+    void fill(Index index, const IPCIDRValue& value)
+    {
+        set_wide(index, value.get_prefix());
+    }
+
+    void fill(Index index, const IPRangeValue& value)
+    {
+        set_wide(index, value.get_range());
+    }
+
+    void fill(Index index, const IPv6AddressValue& value)
+    {
+        set_wide(index, value.get_address());
+    }
+
+    void fill(Index index, const IPv6CIDRValue& value)
+    {
+        set_wide(index, value.get_prefix());
+    }
+
+    void fill(Index index, const IPv6RangeValue& value)
+    {
+        set_wide(index, value.get_range());
+    }
+
+    // Datatypes are not part of the tree
+    void fill(Index, const ASTNodeInterface&) {}
+
+    // Stores text in the pool once, however many nodes use it
+    void set_text(Index index, std::string_view text)
+    {
+        if (text.empty()) {
+            return;
+        }
+        auto pooled = text_ids.find(text);
+        if (pooled == text_ids.end()) {
+            uint32_t id = static_cast<uint32_t>(ast.texts.size());
+            ast.texts.push_back(TextRange{static_cast<uint32_t>(ast.pool.size()), static_cast<uint32_t>(text.size())});
+            ast.pool.append(text.data(), text.size());
+            pooled = text_ids.emplace(text, id).first;
+        }
+        ast.text_ids[index] = pooled->second;
+    }
+
+    // Copies the bytes of literal to whole words of the side table
+    template <typename Literal>
+    void set_wide(Index index, const Literal& literal)
+    {
+        size_t offset = ast.wide.size();
+        ast.wide.resize(offset + (sizeof(Literal) + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        memcpy(ast.wide.data() + offset, &literal, sizeof(Literal));
+        ast.payloads[index] = static_cast<uint32_t>(offset);
+    }
+
+    FlatAst& ast;
+    // Keys are views of the program's own texts, which outlive the build
+    std::unordered_map<std::string_view, uint32_t> text_ids;
+};
+
+FlatAst::FlatAst(const ProgramDeclaration& program)
+{
+    Builder(*this).add(&program);
+
+    kinds.shrink_to_fit();
+    spans.shrink_to_fit();
+    ends.shrink_to_fit();
+    symbols.shrink_to_fit();
+    text_ids.shrink_to_fit();
+    payloads.shrink_to_fit();
+    texts.shrink_to_fit();
+    wide.shrink_to_fit();
+    pool.shrink_to_fit();
+}
+
+FlatAst::Index FlatAst::size() const noexcept
+{
+    return static_cast<Index>(kinds.size());
+}
+
+NodeKind FlatAst::get_kind(Index node) const noexcept
+{
+    return kinds[node];
+}
+
+SourceSpan FlatAst::get_span(Index node) const noexcept
+{
+    return spans[node];
+}
+
+FlatAst::Index FlatAst::get_end(Index node) const noexcept
+{
+    return ends[node];
+}
+
+std::string_view FlatAst::get_text(Index node) const noexcept
+{
+    const TextRange& text = texts[text_ids[node]];
+    return std::string_view(pool.data() + text.offset, text.length);
+}
+
+Symbol FlatAst::get_symbol(Index node) const noexcept
+{
+    return symbols[node];
+}
+
+SectionStatement::SectionType FlatAst::get_section_type(Index node) const noexcept
+{
+    return static_cast<SectionStatement::SectionType>(payloads[node]);
+}
+
+bool FlatAst::is_quoted(Index node) const noexcept
+{
+    return payloads[node] != 0;
+}
+
+int FlatAst::get_number(Index node) const noexcept
+{
+    return static_cast<int>(payloads[node]);
+}
+
+bool FlatAst::get_boolean(Index node) const noexcept
+{
+    return payloads[node] != 0;
+}
+
+uint32_t FlatAst::get_ipv4_address(Index node) const noexcept
+{
+    return payloads[node];
+}
+
+template <typename Literal>
+Literal FlatAst::get_wide(Index node) const noexcept
+{
+    Literal literal;
+    memcpy(&literal, wide.data() + payloads[node], sizeof(Literal));
+    return literal;
+}
+
+IPv4Prefix FlatAst::get_ipv4_prefix(Index node) const noexcept
+{
+    return get_wide<IPv4Prefix>(node);
+}
+
+IPv4Range FlatAst::get_ipv4_range(Index node) const noexcept
+{
+    return get_wide<IPv4Range>(node);
+}
+
+IPv6Address FlatAst::get_ipv6_address(Index node) const noexcept
+{
+    return get_wide<IPv6Address>(node);
+}
+
+IPv6Prefix FlatAst::get_ipv6_prefix(Index node) const noexcept
+{
+    return get_wide<IPv6Prefix>(node);
+}
+
+IPv6Range FlatAst::get_ipv6_range(Index node) const noexcept
+{
+    return get_wide<IPv6Range>(node);
+}
+
+size_t FlatAst::memory_size() const noexcept
+{
+    return kinds.capacity() * sizeof(NodeKind) + spans.capacity() * sizeof(SourceSpan) +
+           ends.capacity() * sizeof(Index) + symbols.capacity() * sizeof(Symbol) +
+           text_ids.capacity() * sizeof(uint32_t) + payloads.capacity() * sizeof(uint32_t) +
+           texts.capacity() * sizeof(TextRange) + wide.capacity() * sizeof(uint32_t) + pool.capacity();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "declaration.hpp"
+#include "ip_literal.hpp"
+#include "statement.hpp"
+
+// Compact copy of a parsed program: the fields of every node in parallel
+// arrays addressed by a 32-bit index, instead of a graph of polymorphic
+// nodes. Nodes are stored in source order, each one before its children
+// (the program is node 0), so the subtree of a node is the range
+// [node + 1, get_end(node)) and a pass over the whole tree walks the arrays
+// front to back. The first child of a node is node + 1, each next one
+// starts where the subtree of the previous one ends.
+//
+// Names and strings are copied into a pool of the FlatAst, each text once,
+// so it does not need the source nor the AstArena it was built from.
+// Literals wider than the 32-bit payload are copied to a side table.
+//
+// The compiler does not build one: as long as the parser builds the node
+// graph, the copy costs more than a pass over it saves (make bench-ast).
+class FlatAst
+{
+public:
+    using Index = uint32_t;
+
+    explicit FlatAst(const ProgramDeclaration& program);
+
+    Index size() const noexcept;
+    NodeKind get_kind(Index node) const noexcept;
+    SourceSpan get_span(Index node) const noexcept;
+    // One past the last node of the subtree of node
+    Index get_end(Index node) const noexcept;
+
+    // Name of a section, property, config declaration, identifier or
+    // referenced property, text of a string (without quotes); empty for
+    // other nodes
+    std::string_view get_text(Index node) const noexcept;
+    // Name of a section or property as a symbol, Symbol::NONE otherwise
+    Symbol get_symbol(Index node) const noexcept;
+
+    // Payload of a node, each for the kind it is named after
+    SectionStatement::SectionType get_section_type(Index node) const noexcept;
+    bool is_quoted(Index node) const noexcept;
+    int get_number(Index node) const noexcept;
+    bool get_boolean(Index node) const noexcept;
+    uint32_t get_ipv4_address(Index node) const noexcept;
+    IPv4Prefix get_ipv4_prefix(Index node) const noexcept;
+    IPv4Range get_ipv4_range(Index node) const noexcept;
+    IPv6Address get_ipv6_address(Index node) const noexcept;
+    IPv6Prefix get_ipv6_prefix(Index node) const noexcept;
+    IPv6Range get_ipv6_range(Index node) const noexcept;
+
+    // Bytes held by the arrays and the pool
+    size_t memory_size() const noexcept;
+
+private:
+    class Builder;
+
+    struct TextRange
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    template <typename Literal>
+    Literal get_wide(Index node) const noexcept;
+
+    std::vector<NodeKind> kinds;
+    std::vector<SourceSpan> spans;
+    std::vector<Index> ends;
+    std::vector<Symbol> symbols;
+    // Entry of texts, 0 (the empty text) for nodes without one
+    std::vector<uint32_t> text_ids;
+    // Section type, quoted flag, number, boolean, IPv4 address or the
+    // offset of a wide literal in wide
+    std::vector<uint32_t> payloads;
+    std::vector<TextRange> texts;
+    std::vector<uint32_t> wide;
+    std::string pool;
+};
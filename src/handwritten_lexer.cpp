@@ -0,0 +1,751 @@
+#include "handwritten_lexer.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ip_literal.hpp"
+#include "keyword_table.hpp"
+
+// Character classes of scanner.flex
+static inline bool is_blank(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool is_digit(char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline bool is_letter(char c) noexcept
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static inline bool is_hex(char c) noexcept
+{
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static inline bool is_identifier_char(char c) noexcept
+{
+    return is_letter(c) || is_digit(c) || c == '_';
+}
+
+static size_t digit_run(const char* p, const char* limit) noexcept
+{
+    const char* q = p;
+    while (q < limit && is_digit(*q)) ++q;
+    return q - p;
+}
+
+// OCTET of scanner.flex spanning exactly n digits
+static bool is_octet(const char* p, size_t n) noexcept
+{
+    switch (n) {
+        case 1: return true;
+        case 2: return p[0] != '0';
+        case 3: return p[0] == '1' || (p[0] == '2' && (p[1] < '5' || (p[1] == '5' && p[2] <= '5')));
+        default: return false;
+    }
+}
+
+// Longest OCTET at the start of a run of n digits
+static size_t octet_prefix(const char* p, size_t n) noexcept
+{
+    if (p[0] == '0') return 1;
+    if (n >= 3 && is_octet(p, 3)) return 3;
+    return n >= 2 ? 2 : 1;
+}
+
+// Dotted quad at p. longest is the longest match (the last octet may stop
+// inside its digit run), whole the match ending after the whole last digit
+// run, or 0 if that run is not an octet (nothing may follow it then).
+static bool match_quad(const char* p, const char* limit, size_t& longest, size_t& whole) noexcept
+{
+    const char* q = p;
+    for (int i = 0; i < 3; ++i) {
+        size_t n = digit_run(q, limit);
+        if (n == 0 || !is_octet(q, n) || q + n >= limit || q[n] != '.') {
+            return false;
+        }
+        q += n + 1;
+    }
+    size_t n = digit_run(q, limit);
+    if (n == 0) {
+        return false;
+    }
+    longest = (q - p) + octet_prefix(q, n);
+    whole = is_octet(q, n) ? (q - p) + n : 0;
+    return true;
+}
+
+HandwrittenLexer::HandwrittenLexer(ParserContext& ctx, const char* begin, const char* end)
+    : ctx(ctx), input(begin), cursor(begin), limit(end),
+      state(ctx.only_sections.empty() ? State::INITIAL : State::INDENT)
+{
+    load_lines();
+}
+
+void HandwrittenLexer::next_piece(const char* begin, const char* end)
+{
+    input_offset += static_cast<uint32_t>(limit - input);
+    input = cursor = begin;
+    limit = end;
+    load_lines();
+}
+
+// Stream reads, the refill grows the buffer past this only for long lines
+static constexpr size_t stream_chunk_size = 65536;
+
+HandwrittenLexer::HandwrittenLexer(ParserContext& ctx, FILE* stream)
+    : ctx(ctx), input(nullptr), cursor(nullptr), limit(nullptr),
+      state(ctx.only_sections.empty() ? State::INITIAL : State::INDENT), stream(stream), buffer(stream_chunk_size)
+{
+    input = cursor = limit = buffer.data();
+}
+
+bool HandwrittenLexer::more_input() const noexcept
+{
+    return stream != nullptr && !stream_ended;
+}
+
+bool HandwrittenLexer::refill()
+{
+    if (!more_input()) {
+        return false;
+    }
+
+    // Keep the unconsumed part of the buffer
+    input_offset += static_cast<uint32_t>(cursor - buffer.data());
+    size_t kept = filled - (cursor - buffer.data());
+    size_t searched = limit - cursor;
+    memmove(buffer.data(), cursor, kept);
+    filled = kept;
+
+    // Read until there is a new line break, or the stream ends
+    const char* line_end = nullptr;
+    while (line_end == nullptr) {
+        for (size_t i = filled; i > searched; --i) {
+            if (buffer[i - 1] == '\n') {
+                line_end = buffer.data() + i;
+                break;
+            }
+        }
+        if (line_end != nullptr) {
+            break;
+        }
+        searched = filled;
+        if (stream_ended) {
+            line_end = buffer.data() + filled;
+            break;
+        }
+        if (buffer.size() - filled < stream_chunk_size) {
+            buffer.resize(buffer.size() * 2);
+        }
+        size_t count = fread(buffer.data() + filled, 1, stream_chunk_size, stream);
+        filled += count;
+        if (count == 0) {
+            stream_ended = true;
+        }
+    }
+
+    input = cursor = buffer.data();
+    limit = line_end;
+    load_lines();
+    return limit > cursor || more_input();
+}
+
+void HandwrittenLexer::load_lines()
+{
+    // Larger inputs fall back to scanning indentation byte by byte
+    if (static_cast<size_t>(limit - input) <= LineTable::max_input_size) {
+        line_table.build(input, limit - input);
+        record_lines();
+    } else {
+        line_table.clear();
+    }
+    next_line = 0;
+}
+
+void HandwrittenLexer::record_lines()
+{
+    for (const LineInfo& line : line_table.get_lines()) {
+        ctx.line_index.add_line(input_offset + line.offset);
+    }
+}
+
+void HandwrittenLexer::set_location(YYLTYPE* lloc, const char* begin) noexcept
+{
+    lloc->offset = input_offset + static_cast<uint32_t>(begin - input);
+    lloc->length = static_cast<uint32_t>(cursor - begin);
+    ctx.scan_offset = lloc->end();
+}
+
+int HandwrittenLexer::scan(YYSTYPE* lval, YYLTYPE* lloc)
+{
+    for (;;) {
+        if (state == State::INDENT) {
+            int token = scan_indent();
+            if (token != 0) {
+                // INDENT/DEDENT take no characters
+                set_location(lloc, cursor);
+                return token;
+            }
+            if (state == State::INDENT) {
+                // Out of whole lines while skipping blank ones
+                if (refill()) {
+                    continue;
+                }
+                return 0;
+            }
+            // Same indentation level, go on with the line
+        }
+        int token = scan_initial(lval);
+        if (token != 0) {
+            set_location(lloc, token_begin);
+            return token;
+        }
+        if (!refill()) {
+            return 0;
+        }
+    }
+}
+
+int HandwrittenLexer::scan_indent()
+{
+    const std::vector<LineInfo>& lines = line_table.get_lines();
+    if (lines.empty()) {
+        return scan_indent_bytes();
+    }
+
+    // The INDENT state always starts right after a newline, i.e. at a line
+    // of the table; blank and comment lines are skipped without touching
+    // their bytes again
+    size_t i = line_table.find_line(static_cast<uint32_t>(cursor - input), next_line);
+    for (; i < lines.size(); ++i) {
+        const LineInfo& line = lines[i];
+        if (line.indent > 0) {
+            ctx.current_indent = line.indent;
+        }
+        if (!line.blank) {
+            const char* first = input + line.offset + line.indent;
+            cursor = first;
+            size_t separator = ctx.current_indent == 0 ? match_document_separator() : 0;
+            if (separator > 0) {
+                cursor += separator;
+                next_line = i + 1;
+                ctx.skipping_section = false;
+                return ctx.queue_document_separator();
+            }
+            if (!skip_unselected_line()) {
+                next_line = i + 1;
+                return process_indentation();
+            }
+            if (cursor == first) {
+                // The line goes on in the next chunk of the stream
+                next_line = i;
+                return 0;
+            }
+            // Go on with the line after it
+            next_line = i + 1;
+            i = line_table.find_line(static_cast<uint32_t>(cursor - input), next_line) - 1;
+            continue;
+        }
+        if (i + 1 == lines.size()) {
+            break;
+        }
+        // Skip empty lines, but still count line numbers
+        ctx.line_number++;
+        ctx.current_indent = 0;
+    }
+    cursor = limit;
+    next_line = lines.size();
+    return 0;
+}
+
+int HandwrittenLexer::scan_indent_bytes()
+{
+    while (cursor < limit) {
+        char c = *cursor;
+        if (is_blank(c)) {
+            // Count spaces for indentation
+            const char* start = cursor;
+            while (cursor < limit && is_blank(*cursor)) ++cursor;
+            if (ctx.at_line_start) {
+                ctx.current_indent = static_cast<int>(cursor - start);
+            }
+        } else if (c == '#') {
+            // Skip comments at the start of line
+            const char* newline = static_cast<const char*>(memchr(cursor, '\n', limit - cursor));
+            cursor = newline ? newline : limit;
+        } else if (c == '\n') {
+            // Skip empty lines, but still count line numbers
+            ++cursor;
+            ctx.line_number++;
+            ctx.current_indent = 0;
+        } else {
+            size_t separator = ctx.current_indent == 0 ? match_document_separator() : 0;
+            if (separator > 0) {
+                cursor += separator;
+                ctx.skipping_section = false;
+                return ctx.queue_document_separator();
+            }
+            const char* first = cursor;
+            if (!skip_unselected_line()) {
+                return process_indentation();
+            }
+            if (cursor == first) {
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+size_t HandwrittenLexer::match_document_separator() const noexcept
+{
+    if (limit - cursor < 3 || cursor[0] != '-' || cursor[1] != '-' || cursor[2] != '-') {
+        return 0;
+    }
+    const char* end = cursor + 3;
+    while (end < limit && is_blank(*end)) ++end;
+    if (end < limit && *end == '#') {
+        const char* newline = static_cast<const char*>(memchr(end, '\n', limit - end));
+        end = newline ? newline : limit;
+    }
+    // Pieces and stream chunks end after a newline, so the limit without
+    // one is the end of the input: the separator is on the last line
+    if (end == limit) {
+        return more_input() ? 0 : end - cursor;
+    }
+    return *end == '\n' ? end - cursor : 0;
+}
+
+std::string_view HandwrittenLexer::match_section_header() const noexcept
+{
+    const char* end = cursor;
+    while (end < limit && ((*end >= 'a' && *end <= 'z') || (*end >= 'A' && *end <= 'Z'))) ++end;
+    const char* colon = end;
+    while (colon < limit && is_blank(*colon)) ++colon;
+    if (end == cursor || colon == limit || *colon != ':') {
+        return std::string_view();
+    }
+    return std::string_view(cursor, end - cursor);
+}
+
+bool HandwrittenLexer::skip_unselected_line()
+{
+    if (ctx.only_sections.empty()) {
+        return false;
+    }
+    // A line at column 0 starts the next top-level chunk, the section goes
+    // on while the lines are indented
+    if (ctx.current_indent == 0) {
+        ctx.skipping_section = ctx.is_section_skipped(match_section_header());
+    }
+    if (!ctx.skipping_section) {
+        return false;
+    }
+
+    // Same tokens as the SKIP_SECTION rules of the scanner: strings and
+    // comments may hide a newline
+    const char* first = cursor;
+    while (cursor < limit && *cursor != '\n') {
+        char c = *cursor;
+        if (c == '#') {
+            const char* newline = static_cast<const char*>(memchr(cursor, '\n', limit - cursor));
+            cursor = newline ? newline : limit;
+        } else if (c == '"') {
+            size_t length = match_multiline_comment();
+            bool open_comment = length == 0 && limit - cursor >= 3 && cursor[1] == '"' && cursor[2] == '"';
+            if (length == 0) {
+                const char* closing = static_cast<const char*>(memchr(cursor + 1, '"', limit - cursor - 1));
+                length = closing ? closing + 1 - cursor : 0;
+            }
+            if (more_input() && (length == 0 || open_comment)) {
+                // The string or comment may end in a later chunk
+                cursor = first;
+                return true;
+            }
+            if (length == 0) {
+                length = 1;  // A quote that is never closed
+            }
+            for (const char* p = cursor; p < cursor + length; ++p) {
+                if (*p == '\n') ctx.line_number++;
+            }
+            cursor += length;
+        } else {
+            ++cursor;
+        }
+    }
+    if (cursor < limit) {
+        ++cursor;
+        ctx.line_number++;
+    }
+    ctx.current_indent = 0;
+    return true;
+}
+
+int HandwrittenLexer::process_indentation()
+{
+    // End of whitespace - process indentation changes, nothing is consumed
+    if (ctx.current_indent > ctx.indent_stack.back()) {
+        ctx.indent_stack.push_back(ctx.current_indent);
+        ctx.at_line_start = false;
+        state = State::INITIAL;
+        return TOKEN_INDENT;
+    } else if (ctx.current_indent < ctx.indent_stack.back()) {
+        bool found_matching_indent = false;
+        for (int i = ctx.indent_stack.size() - 1; i >= 0; i--) {
+            if (ctx.current_indent == ctx.indent_stack[i]) {
+                found_matching_indent = true;
+                break;
+            }
+        }
+
+        if (!found_matching_indent) {
+            // Report it and go on as if the line were at the nearest level above
+            uint32_t offset = input_offset + static_cast<uint32_t>(cursor - input);
+            ctx.report_syntax_error(SourceSpan{offset, 0},
+                                    "Invalid dedentation level " + std::to_string(ctx.current_indent));
+            ctx.current_indent = ctx.nearest_indent_above(ctx.current_indent);
+        }
+
+        if (ctx.current_indent < ctx.indent_stack.back()) {
+            // Pop one level and queue any further DEDENTs
+            ctx.indent_stack.pop_back();
+            while (ctx.current_indent < ctx.indent_stack.back()) {
+                ctx.indent_stack.pop_back();
+                ctx.token_queue.push_back(TOKEN_DEDENT);
+            }
+
+            ctx.at_line_start = false;
+            state = State::INITIAL;
+            return TOKEN_DEDENT;
+        }
+        // Still in the innermost block
+        ctx.at_line_start = false;
+        state = State::INITIAL;
+        return 0;
+    } else {
+        ctx.at_line_start = false;
+        state = State::INITIAL;
+        return 0;
+    }
+}
+
+int HandwrittenLexer::scan_initial(YYSTYPE* lval)
+{
+    while (cursor < limit) {
+        token_begin = cursor;
+        char c = *cursor;
+        size_t length = 0;
+        int token = 0;
+
+        switch (c) {
+            case '\n':
+                ++cursor;
+                ctx.line_number++;
+                ctx.at_line_start = true;
+                ctx.current_indent = 0;  // A line without leading blanks is at 0
+                state = State::INDENT;
+                return TOKEN_NEWLINE;
+            case ' ':
+            case '\t':
+            case '\r':
+                while (cursor < limit && is_blank(*cursor)) ++cursor;
+                continue;
+            case '#': {
+                const char* newline = static_cast<const char*>(memchr(cursor, '\n', limit - cursor));
+                cursor = newline ? newline : limit;
+                continue;
+            }
+            case '"': {
+                // """...""" comments are ignored, newlines in them still count
+                length = match_multiline_comment();
+                if (more_input() && length == 0 && limit - cursor >= 3 && cursor[1] == '"' && cursor[2] == '"') {
+                    // The comment may end in a later chunk
+                    refill();
+                    continue;
+                }
+                if (length > 0) {
+                    for (const char* p = cursor; p < cursor + length; ++p) {
+                        if (*p == '\n') ctx.line_number++;
+                    }
+                    cursor += length;
+                    continue;
+                }
+                // Strings keep their quotes and may span lines
+                const char* closing = static_cast<const char*>(memchr(cursor + 1, '"', limit - cursor - 1));
+                if (closing == nullptr && more_input()) {
+                    refill();
+                    continue;
+                }
+                if (closing == nullptr) {
+                    ++cursor;
+                    return TOKEN_UNKNOWN;
+                }
+                length = closing + 1 - cursor;
+                lval->text_val = ctx.keep_text(cursor, length);
+                cursor += length;
+                return TOKEN_STRING;
+            }
+            default:
+                break;
+        }
+
+        // An IPv6 literal is always the longest match where it is valid
+        if (c == ':' || is_hex(c)) {
+            token = match_ipv6(lval, length);
+            if (token != 0) {
+                cursor += length;
+                return token;
+            }
+        }
+
+        switch (c) {
+            case ':': ++cursor; return TOKEN_COLON;
+            case '=': ++cursor; return TOKEN_EQUALS;
+            case '[': ++cursor; return TOKEN_LEFT_BRACKET;
+            case ']': ++cursor; return TOKEN_RIGHT_BRACKET;
+            case '{': ++cursor; return TOKEN_LEFT_BRACE;
+            case '}': ++cursor; return TOKEN_RIGHT_BRACE;
+            case ',': ++cursor; return TOKEN_COMMA;
+            case '/': ++cursor; return TOKEN_SLASH;
+            case '-':
+                // Only the first line is scanned here at its start, the
+                // document separators of the others are found by scan_indent
+                length = cursor == input && input_offset == 0 ? match_document_separator() : 0;
+                if (length > 0) {
+                    cursor += length;
+                    ctx.skipping_section = false;
+                    state = State::INDENT;
+                    return ctx.queue_document_separator();
+                }
+                ++cursor;
+                return TOKEN_MINUS;
+            case '.': ++cursor; return TOKEN_DOT;
+            case ';': ++cursor; return TOKEN_SEMICOLON;
+            default: break;
+        }
+
+        if (is_digit(c)) {
+            token = match_ipv4(lval, length);
+            if (token == 0) {
+                // The digit run is followed by a non-digit, atoi stops there
+                length = digit_run(cursor, limit);
+                lval->int_val = atoi(cursor);
+                token = TOKEN_NUMBER;
+            }
+            cursor += length;
+            return token;
+        }
+
+        if (is_letter(c)) {
+            token = match_word(lval, length);
+            cursor += length;
+            return token;
+        }
+
+        ++cursor;
+        return TOKEN_UNKNOWN;
+    }
+    return 0;
+}
+
+int HandwrittenLexer::match_ipv6(YYSTYPE* lval, size_t& length) const
+{
+    std::string_view text(cursor, limit - cursor);
+    IPv6Address address;
+    size_t end = scan_ipv6(text, address);
+    if (end == 0) {
+        return 0;
+    }
+
+    uint8_t prefix_length;
+    size_t length_chars = scan_ipv6_prefix_length(text, end, prefix_length);
+    if (length_chars > 0) {
+        length = end + length_chars;
+        lval->ipv6_prefix_val = IPv6Prefix{address, prefix_length};
+        return TOKEN_IPV6_CIDR;
+    }
+
+    if (end < text.size() && text[end] == '-') {
+        IPv6Address last;
+        size_t last_end = scan_ipv6(text.substr(end + 1), last);
+        if (last_end > 0) {
+            length = end + 1 + last_end;
+            lval->ipv6_range_val = IPv6Range{address, last};
+            return TOKEN_IPV6_RANGE;
+        }
+    }
+
+    length = end;
+    lval->ipv6_val = address;
+    return TOKEN_IPV6_ADDRESS;
+}
+
+int HandwrittenLexer::match_ipv4(YYSTYPE* lval, size_t& length) const
+{
+    size_t longest, whole;
+    if (!match_quad(cursor, limit, longest, whole)) {
+        return 0;
+    }
+
+    int token = TOKEN_IP_ADDRESS;
+    length = longest;
+
+    if (whole > 0 && cursor + whole + 1 < limit) {
+        const char* after = cursor + whole;
+        if (after[0] == '/' && is_digit(after[1])) {
+            // Longest of 3[0-2], [1-2][0-9] and [0-9]
+            bool two_digits = after + 2 < limit &&
+                (((after[1] == '1' || after[1] == '2') && is_digit(after[2])) ||
+                 (after[1] == '3' && after[2] >= '0' && after[2] <= '2'));
+            size_t cidr_length = whole + 1 + (two_digits ? 2 : 1);
+            if (cidr_length > length) {
+                token = TOKEN_IP_CIDR;
+                length = cidr_length;
+            }
+        } else if (after[0] == '-') {
+            size_t last_longest, last_whole;
+            if (match_quad(after + 1, limit, last_longest, last_whole) && whole + 1 + last_longest > length) {
+                token = TOKEN_IP_RANGE;
+                length = whole + 1 + last_longest;
+            }
+        }
+    }
+
+    std::string_view text(cursor, length);
+    if (token == TOKEN_IP_CIDR) {
+        decode_ipv4_prefix(text, lval->ipv4_prefix_val);
+    } else if (token == TOKEN_IP_RANGE) {
+        decode_ipv4_range(text, lval->ipv4_range_val);
+    } else {
+        decode_ipv4(text, lval->ipv4_val);
+    }
+    return token;
+}
+
+int HandwrittenLexer::match_word(YYSTYPE* lval, size_t& length) const
+{
+    size_t word = 1;
+    while (cursor + word < limit && is_identifier_char(cursor[word])) ++word;
+
+    if (cursor + word < limit && cursor[word] == '-') {
+        size_t tail = 0;
+        while (cursor + word + 1 + tail < limit && is_identifier_char(cursor[word + 1 + tail])) ++tail;
+        int token = 0;
+        length = match_hyphenated_keyword(std::string_view(cursor, word + 1 + tail), word, token);
+        if (length > 0) {
+            return token;
+        }
+    }
+
+    length = word;
+    int token = lookup_keyword(std::string_view(cursor, word));
+    if (token == TOKEN_BOOL) {
+        lval->int_val = (cursor[0] == 't');
+    } else if (token == 0) {
+        lval->text_val = ctx.keep_text(cursor, word);
+        token = TOKEN_IDENTIFIER;
+    }
+    return token;
+}
+
+// Length of a """...""" comment at the cursor, 0 if there is none.
+// Same as the MULTILINE pattern: the body never contains three quotes in a
+// row, so the comment ends at the first """ after the opening one.
+size_t HandwrittenLexer::match_multiline_comment() const noexcept
+{
+    if (limit - cursor < 6 || cursor[1] != '"' || cursor[2] != '"') {
+        return 0;
+    }
+    int quotes = 0;
+    for (const char* p = cursor + 3; p < limit; ++p) {
+        if (*p != '"') {
+            quotes = 0;
+        } else if (++quotes == 3) {
+            return p + 1 - cursor;
+        }
+    }
+    return 0;
+}
+
+// Scanner entry point used by the parser, same contract as the flex backend
+int yylex(YYSTYPE* yylval_param, YYLTYPE* yylloc_param, ParserContext* ctx)
+{
+    // First check if we have any tokens in the queue
+    int token = ctx->pop_queued_token();
+    if (token != 0) {
+        *yylloc_param = SourceSpan{ctx->scan_offset, 0};
+        return token;
+    }
+
+    token = static_cast<HandwrittenLexer*>(ctx->scanner)->scan(yylval_param, yylloc_param);
+
+    // If we reached EOF, handle any pending dedent tokens
+    if (token == 0 && ctx->input_complete) {
+        ctx->queue_eof_tokens();
+        token = ctx->pop_queued_token();
+        *yylloc_param = SourceSpan{ctx->scan_offset, 0};
+    }
+
+    return token;
+}
+
+int netforge_parse_file(ParserContext& ctx, FILE* input)
+{
+    // Token text is copied out of the chunk buffer (see
+    // ParserContext::keep_text), so it can go away after parsing
+    HandwrittenLexer lexer(ctx, input);
+    ctx.scanner = &lexer;
+    int parse_result = yyparse(&ctx);
+    ctx.scanner = nullptr;
+    return parse_result;
+}
+
+int netforge_scan_piece(ParserContext& ctx, const char* data, size_t length)
+{
+    auto* lexer = static_cast<HandwrittenLexer*>(ctx.scanner);
+    if (lexer == nullptr) {
+        ctx.scanner = new HandwrittenLexer(ctx, data, data + length);
+    } else {
+        lexer->next_piece(data, data + length);
+    }
+    return 0;
+}
+
+int netforge_scan_begin(ParserContext& ctx, const char* path)
+{
+    if (!ctx.source.open(path)) {
+        return -1;
+    }
+    const char* begin = ctx.source.get_data();
+    ctx.scanner = new HandwrittenLexer(ctx, begin, begin + ctx.source.get_size());
+    return 0;
+}
+
+void netforge_scan_end(ParserContext& ctx)
+{
+    delete static_cast<HandwrittenLexer*>(ctx.scanner);
+    ctx.scanner = nullptr;
+}
+
+int netforge_parse_path(ParserContext& ctx, const char* path)
+{
+    int begin_result = netforge_scan_begin(ctx, path);
+    if (begin_result != 0) {
+        return begin_result;
+    }
+
+    int parse_result = yyparse(&ctx);
+
+    netforge_scan_end(ctx);
+    return parse_result;
+}
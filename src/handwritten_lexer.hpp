@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdio.h>
+#include <string_view>
+#include <vector>
+
+#include "line_table.hpp"
+#include "parser_context.hpp"
+#include "parser.tab.h"
+
+// Hand-written alternative to the flex scanner (build with LEXER=handwritten).
+// It follows the rules of scanner.flex exactly, longest match included, so
+// both backends hand the parser the same token stream; keywords are resolved
+// through a perfect hash over keywords.def instead of one DFA path each.
+class HandwrittenLexer
+{
+public:
+    // Scans [begin, end); token text that points into ctx.source is kept
+    // without copying (see ParserContext::keep_text)
+    HandwrittenLexer(ParserContext& ctx, const char* begin, const char* end);
+    // Scans a stream (a pipe, stdin) read in fixed-size chunks; only whole
+    // lines are scanned, so at most one chunk plus the longest line (or
+    // multi-line string) is buffered at a time
+    HandwrittenLexer(ParserContext& ctx, FILE* stream);
+
+    // Next token, 0 at the end of the input (the EOF INDENT/DEDENT handling
+    // is done by yylex() through the ParserContext queue)
+    int scan(YYSTYPE* lval, YYLTYPE* lloc);
+
+    // Goes on with [begin, end), the next piece of the input (see
+    // netforge_scan_piece); the current one must have been scanned
+    void next_piece(const char* begin, const char* end);
+
+private:
+    // Mirrors the INITIAL and INDENT_STATE start conditions of the scanner
+    enum class State {
+        INITIAL,
+        INDENT
+    };
+
+    int scan_initial(YYSTYPE* lval);
+    // Returns a token, or 0 at the end of the input or when the line keeps
+    // the current indentation (the state is INITIAL again then)
+    int scan_indent();
+    // Same without the line table, one byte at a time
+    int scan_indent_bytes();
+    // Emits INDENT/DEDENT for ctx.current_indent at the first token of a line
+    int process_indentation();
+    // With ctx.only_sections, true if the line whose first non-blank byte is
+    // at cursor belongs to a section left out (its header or a line indented
+    // under it). cursor is then past the line, or left where it was when the
+    // line goes on in input not read yet.
+    bool skip_unselected_line();
+
+    // Streams only: drops the consumed input and reads up to the next line
+    // break. Returns false at the end of the stream.
+    bool refill();
+    bool more_input() const noexcept;
+
+    // Pre-scans the lines of [input, limit)
+    void load_lines();
+    // Adds the lines of line_table to ctx.line_index
+    void record_lines();
+    // Span of [begin, cursor), also remembered as the end of the last token
+    void set_location(YYLTYPE* lloc, const char* begin) noexcept;
+
+    int match_ipv6(YYSTYPE* lval, size_t& length) const;
+    int match_ipv4(YYSTYPE* lval, size_t& length) const;
+    int match_word(YYSTYPE* lval, size_t& length) const;
+    size_t match_multiline_comment() const noexcept;
+    // Length of a "---" document separator line at cursor (up to its
+    // newline or the end of the input), 0 if there is none
+    size_t match_document_separator() const noexcept;
+    // Name of the top-level section whose header ("name:") is at cursor, ""
+    // if there is none
+    std::string_view match_section_header() const noexcept;
+
+    ParserContext& ctx;
+    const char* input;
+    uint32_t input_offset = 0;  // Offset of input in the whole source
+    const char* cursor;
+    const char* token_begin = nullptr;
+    const char* limit;
+    // The first line goes through the INDENT rules too when sections may be
+    // skipped, so one at the very start of the input can be
+    State state;
+
+    // Pre-scanned lines and the first one not consumed yet
+    LineTable line_table;
+    size_t next_line = 0;
+
+    // Stream input: buffer holds filled bytes, [input, limit) are whole lines
+    FILE* stream = nullptr;
+    std::vector<char> buffer;
+    size_t filled = 0;
+    bool stream_ended = false;
+};
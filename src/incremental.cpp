@@ -0,0 +1,425 @@
+#include "incremental.hpp"
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+#include "module_cache.hpp"
+#include "specialized_sections.hpp"
+
+namespace {
+
+// Finds the lines a chunk starts at: the ones whose first byte is not
+// blank or a comment, outside strings and """ comments (a """ comment
+// opening at column 0 does not start a chunk either, it would be one
+// without sections). Same lexical rules as InputCutter (push_parser.hpp).
+class ChunkCutter
+{
+public:
+    // Starts at begin, the start of a chunk (the one at 0 is the only one
+    // that may not start with a section)
+    ChunkCutter(const std::string& text, size_t begin) noexcept
+        : text(text), position(begin) {}
+
+    // Runs over [position, end), appending the chunk starts found
+    void advance(size_t end, std::vector<uint32_t>& starts)
+    {
+        const char* data = text.data();
+        while (position < end) {
+            if (line_start) {
+                line_start = false;
+                char c = data[position];
+                if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '#' && !opens_comment(position)) {
+                    if (skip_first) {
+                        skip_first = false;
+                    } else {
+                        starts.push_back(static_cast<uint32_t>(position));
+                    }
+                }
+            }
+            switch (mode) {
+                case Mode::CODE: {
+                    // Other bytes change nothing, they are skipped in one go
+                    size_t next = position;
+                    while (next < end && data[next] != '\n' && data[next] != '#' && data[next] != '"') {
+                        ++next;
+                    }
+                    position = next;
+                    if (next == end) {
+                        return;
+                    }
+                    if (data[next] == '\n') {
+                        line_start = true;
+                    } else if (data[next] == '#') {
+                        mode = Mode::LINE_COMMENT;
+                    } else if (next + 2 < text.size() && data[next + 1] == '"' && data[next + 2] == '"') {
+                        mode = Mode::MULTILINE_COMMENT;
+                        quotes = 0;
+                        position += 2;
+                    } else {
+                        mode = Mode::STRING;
+                    }
+                    ++position;
+                    break;
+                }
+                case Mode::LINE_COMMENT:
+                case Mode::STRING: {
+                    char closing = mode == Mode::STRING ? '"' : '\n';
+                    const char* found = static_cast<const char*>(memchr(data + position, closing, end - position));
+                    if (found == nullptr) {
+                        position = end;
+                        return;
+                    }
+                    position = found - data + 1;
+                    line_start = mode == Mode::LINE_COMMENT;
+                    mode = Mode::CODE;
+                    break;
+                }
+                case Mode::MULTILINE_COMMENT:
+                    if (data[position] != '"') {
+                        quotes = 0;
+                    } else if (++quotes == 3) {
+                        mode = Mode::CODE;
+                    }
+                    ++position;
+                    break;
+            }
+        }
+    }
+
+    // True if a """ comment opens at position
+    bool opens_comment(size_t at) const noexcept
+    {
+        return text.compare(at, 3, "\"\"\"") == 0;
+    }
+
+    // True if a chunk may end here, i.e. at the start of a line in code
+    bool at_line_start() const noexcept
+    {
+        return line_start && mode == Mode::CODE;
+    }
+
+    // True until the first section of the text has been seen
+    bool before_first_section() const noexcept
+    {
+        return skip_first;
+    }
+
+private:
+    enum class Mode {
+        CODE,
+        LINE_COMMENT,
+        STRING,
+        MULTILINE_COMMENT
+    };
+
+    const std::string& text;
+    bool skip_first = true; // The first section found belongs to the chunk at begin
+    Mode mode = Mode::CODE;
+    int quotes = 0;
+    bool line_start = true;
+    size_t position;
+};
+
+}
+
+IncrementalProgram::IncrementalProgram(std::string source_path)
+    : source_path(std::move(source_path)), program(std::pmr::get_default_resource())
+{
+}
+
+void IncrementalProgram::set_only_sections(std::vector<std::string> names)
+{
+    only_sections = std::move(names);
+}
+
+int IncrementalProgram::parse(std::string new_text, unsigned threads)
+{
+    text = std::move(new_text);
+    chunks.clear();
+    size_t next_chunk = 0;
+    chunks = parse_range(0, static_cast<uint32_t>(text.size()), 1, next_chunk, threads);
+    reparsed_bytes = text.size();
+    link_sections();
+    return get_parse_result();
+}
+
+int IncrementalProgram::edit(size_t offset, size_t removed, std::string_view inserted)
+{
+    if (offset > text.size() || removed > text.size() - offset) {
+        return -1;
+    }
+    if (chunks.empty()) {
+        std::string new_text = text;
+        new_text.replace(offset, removed, inserted);
+        return parse(std::move(new_text));
+    }
+
+    // Chunks touching the changed range, ends included: a change at the
+    // start of a line may join it to the previous chunk or the next one
+    size_t first = std::partition_point(chunks.begin(), chunks.end(), [&](const Chunk& chunk) {
+        return chunk.end() < offset;
+    }) - chunks.begin();
+    size_t last = std::partition_point(chunks.begin(), chunks.end(), [&](const Chunk& chunk) {
+        return chunk.offset <= offset + removed;
+    }) - chunks.begin() - 1;
+
+    uint32_t begin = chunks[first].offset;
+    size_t end = chunks[last].end() - removed + inserted.size();
+    text.replace(offset, removed, inserted);
+
+    size_t next_chunk = last + 1;
+    std::vector<Chunk> parsed = parse_range(begin, static_cast<uint32_t>(end), chunks[first].first_line, next_chunk, 1);
+    reparsed_bytes = 0;
+    for (const Chunk& chunk : parsed) {
+        reparsed_bytes += chunk.length;
+    }
+
+    // The sections of the chunks replaced are replaced in the program,
+    // unless imports are involved: which chunk splices a module shared by
+    // several then depends on all of them
+    bool relink = false;
+    size_t first_section = 0;
+    size_t replaced_sections = 0;
+    for (size_t i = 0; i < next_chunk; ++i) {
+        if (i < first) {
+            first_section += chunks[i].section_count;
+        } else {
+            replaced_sections += chunks[i].section_count;
+            relink = relink || chunks[i].has_imports;
+        }
+    }
+    std::vector<SectionStatement*> sections;
+    for (Chunk& chunk : parsed) {
+        relink = relink || chunk.has_imports;
+        if (chunk.ctx->result) {
+            const auto& chunk_sections = chunk.ctx->result->get_sections();
+            sections.insert(sections.end(), chunk_sections.begin(), chunk_sections.end());
+            chunk.section_count = static_cast<uint32_t>(chunk_sections.size());
+        }
+    }
+
+    // The chunks after the change keep their AST and only move
+    chunks.erase(chunks.begin() + first, chunks.begin() + next_chunk);
+    size_t moved = first + parsed.size();
+    chunks.insert(chunks.begin() + first, std::make_move_iterator(parsed.begin()),
+                  std::make_move_iterator(parsed.end()));
+    for (size_t i = moved; i < chunks.size(); ++i) {
+        chunks[i].offset = chunks[i - 1].end();
+        chunks[i].first_line = chunks[i - 1].first_line + chunks[i - 1].line_count;
+    }
+
+    if (relink) {
+        link_sections();
+    } else {
+        program.replace_sections(first_section, replaced_sections, sections);
+        program.set_span(SourceSpan{0, static_cast<uint32_t>(text.size())});
+    }
+    return get_parse_result();
+}
+
+std::vector<IncrementalProgram::Chunk> IncrementalProgram::parse_range(uint32_t begin, uint32_t end, uint32_t first_line,
+                                                                       size_t& next_chunk, unsigned threads)
+{
+    std::vector<uint32_t> starts{begin};
+    ChunkCutter cutter(text, begin);
+    cutter.advance(end, starts);
+
+    // A change that opens a string or comment runs into the next chunks, as
+    // does one that leaves the first chunk without a section
+    while (end < text.size() && (!cutter.at_line_start() || cutter.before_first_section())) {
+        if (next_chunk < chunks.size()) {
+            end += chunks[next_chunk++].length;
+        } else {
+            end = static_cast<uint32_t>(text.size());
+        }
+        cutter.advance(end, starts);
+    }
+
+    std::vector<Chunk> parsed(starts.size());
+    auto parse_at = [&](size_t i) {
+        uint32_t chunk_end = i + 1 < starts.size() ? starts[i + 1] : end;
+        parsed[i] = parse_chunk(starts[i], chunk_end - starts[i]);
+    };
+    if (threads <= 1 || starts.size() == 1) {
+        for (size_t i = 0; i < starts.size(); ++i) {
+            parse_at(i);
+        }
+    } else {
+        // Chunks share nothing but the module cache. The largest go first,
+        // so a giant section does not start when the others are done.
+        std::vector<size_t> order(starts.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            uint32_t a_end = a + 1 < starts.size() ? starts[a + 1] : end;
+            uint32_t b_end = b + 1 < starts.size() ? starts[b + 1] : end;
+            return a_end - starts[a] > b_end - starts[b];
+        });
+        std::atomic<size_t> next{0};
+        auto work = [&]() {
+            for (size_t k = next++; k < order.size(); k = next++) {
+                parse_at(order[k]);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads && i < starts.size(); ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    for (Chunk& chunk : parsed) {
+        chunk.first_line = first_line;
+        first_line += chunk.line_count;
+    }
+    return parsed;
+}
+
+IncrementalProgram::Chunk IncrementalProgram::parse_chunk(uint32_t offset, uint32_t length) const
+{
+    Chunk chunk;
+    chunk.offset = offset;
+    chunk.length = length;
+    chunk.line_count = static_cast<uint32_t>(std::count(text.begin() + offset, text.begin() + offset + length, '\n'));
+    chunk.ctx = std::make_unique<ParserContext>();
+    chunk.ctx->source_path = source_path;
+    chunk.ctx->only_sections = only_sections;
+
+    // Token text is copied into the chunk's arena, the text may change
+    chunk.parse_result = netforge_parse_buffer(*chunk.ctx, text.data() + offset, length);
+    chunk.has_imports = !chunk.ctx->imports.empty();
+    return chunk;
+}
+
+void IncrementalProgram::link_sections()
+{
+    // Same sections in the same order as a parse of the whole text; a
+    // module imported by several chunks is spliced once
+    auto is_imported = [this](const Module* module) {
+        for (const auto& imported : imports) {
+            if (imported.get() == module) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    program.clear_sections();
+    imports.clear();
+    for (Chunk& chunk : chunks) {
+        chunk.section_count = 0;
+        const ProgramDeclaration* chunk_program = chunk.ctx->result;
+        if (!chunk_program) {
+            continue;
+        }
+        for (size_t i = 0; i < chunk_program->get_sections().size(); ++i) {
+            const Module* module = chunk_program->get_section_module(i);
+            if (module == nullptr || !is_imported(module)) {
+                program.add_imported_section(chunk_program->get_sections()[i], module);
+                ++chunk.section_count;
+            }
+        }
+        for (const auto& module : chunk.ctx->imports) {
+            if (!is_imported(module.get())) {
+                imports.push_back(module);
+            }
+        }
+    }
+    program.set_span(SourceSpan{0, static_cast<uint32_t>(text.size())});
+}
+
+int IncrementalProgram::get_parse_result() const noexcept
+{
+    for (const Chunk& chunk : chunks) {
+        if (chunk.parse_result != 0) {
+            return chunk.parse_result;
+        }
+    }
+    return 0;
+}
+
+const std::string& IncrementalProgram::get_text() const noexcept
+{
+    return text;
+}
+
+const ProgramDeclaration* IncrementalProgram::get_result() const noexcept
+{
+    return &program;
+}
+
+std::vector<SyntaxError> IncrementalProgram::get_syntax_errors() const
+{
+    std::vector<SyntaxError> errors;
+    for (const Chunk& chunk : chunks) {
+        for (SyntaxError error : chunk.ctx->syntax_errors) {
+            error.span.offset += chunk.offset;
+            errors.push_back(std::move(error));
+        }
+    }
+    return errors;
+}
+
+bool IncrementalProgram::validate(std::vector<std::string>& errors)
+{
+    bool valid = true;
+    for (Chunk& chunk : chunks) {
+        const ProgramDeclaration* chunk_program = chunk.ctx->result;
+        if (!chunk.validated && chunk_program) {
+            for (size_t i = 0; i < chunk_program->get_sections().size(); ++i) {
+                const SectionStatement* section = chunk_program->get_sections()[i];
+                SourceSpan error_span;
+                std::string error;
+                if (!chunk_program->get_section_module(i) && !check_section(section, error_span, error)) {
+                    chunk.validation_errors.push_back(ValidationError{section->get_name(), error_span, std::move(error)});
+                }
+            }
+        }
+        chunk.validated = true;
+
+        for (const ValidationError& error : chunk.validation_errors) {
+            valid = false;
+            errors.push_back(format_section_error(error.section_name, position(chunk.offset + error.span.offset),
+                                                  error.message));
+        }
+    }
+
+    for (const auto& module : imports) {
+        for (const auto& error : module->validation_errors) {
+            valid = false;
+            errors.push_back(module->path + ": " + error);
+        }
+    }
+    return valid;
+}
+
+SourcePosition IncrementalProgram::position(uint32_t offset) const noexcept
+{
+    auto chunk = std::partition_point(chunks.begin(), chunks.end(), [&](const Chunk& chunk) {
+        return chunk.end() <= offset;
+    });
+    if (chunk == chunks.end()) {
+        if (chunks.empty()) {
+            return SourcePosition{1, offset + 1};
+        }
+        --chunk;
+    }
+    SourcePosition position = chunk->ctx->line_index.position(offset - chunk->offset);
+    position.line += chunk->first_line - 1;
+    return position;
+}
+
+size_t IncrementalProgram::get_chunk_count() const noexcept
+{
+    return chunks.size();
+}
+
+size_t IncrementalProgram::get_reparsed_bytes() const noexcept
+{
+    return reparsed_bytes;
+}
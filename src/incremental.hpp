@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "declaration.hpp"
+#include "parser_context.hpp"
+
+// A DSL file kept parsed across edits, for editors and pre-commit checks
+// that recompile on every change. The text is cut into chunks at the lines
+// starting in column 0 (top-level sections, imports, stray lines), which
+// close every open block, and each chunk is parsed on its own: parsing the
+// chunks one after the other (or on several threads) gives the AST of the
+// whole file. An edit
+// re-lexes and re-parses only the chunks it touches; the other chunks keep
+// their AST, SpecializedSection objects and validation results, only their
+// position in the text moves. The text is one document: the sections of
+// "---" separated documents all end up in the one program.
+class IncrementalProgram
+{
+public:
+    // Imports are resolved relative to source_path ("" for the working
+    // directory), as for a file compiled from that path
+    explicit IncrementalProgram(std::string source_path = std::string());
+
+    IncrementalProgram(const IncrementalProgram&) = delete;
+    IncrementalProgram& operator=(const IncrementalProgram&) = delete;
+
+    // Top-level sections to compile, see ParserContext::only_sections;
+    // applies to the chunks parsed from then on
+    void set_only_sections(std::vector<std::string> names);
+
+    // Parses text from scratch, the chunks on up to threads threads at
+    // once. Returns 0 if it parses, like yyparse().
+    int parse(std::string text, unsigned threads = 1);
+
+    // Replaces removed bytes at offset with inserted and re-parses the
+    // chunks the change touches. Returns 0 if the whole text parses, -1 if
+    // the range is outside the text (nothing is changed then).
+    int edit(size_t offset, size_t removed, std::string_view inserted);
+
+    const std::string& get_text() const noexcept;
+
+    // All top-level sections in text order, imported ones included. The
+    // sections belong to the chunks, an edit may replace some of them.
+    const ProgramDeclaration* get_result() const noexcept;
+
+    // Syntax errors of every chunk, with offsets into the text
+    std::vector<SyntaxError> get_syntax_errors() const;
+
+    // Semantic validation of the program's own sections (cached per chunk)
+    // and of the imported modules; errors are appended formatted like the
+    // compiler reports them. True if there are none.
+    bool validate(std::vector<std::string>& errors);
+
+    // Line and column of an offset into the text
+    SourcePosition position(uint32_t offset) const noexcept;
+
+    size_t get_chunk_count() const noexcept;
+    // Bytes lexed and parsed again by the last parse() or edit()
+    size_t get_reparsed_bytes() const noexcept;
+
+private:
+    struct ValidationError
+    {
+        std::string_view section_name;
+        SourceSpan span;              // Relative to the chunk
+        std::string message;
+    };
+
+    struct Chunk
+    {
+        uint32_t offset = 0;          // In the text
+        uint32_t length = 0;
+        uint32_t first_line = 1;      // Line of the text the chunk starts on
+        uint32_t line_count = 0;      // Newlines in the chunk
+        std::unique_ptr<ParserContext> ctx;  // Its source, AST and errors
+        int parse_result = 0;
+        bool has_imports = false;
+        uint32_t section_count = 0;   // Sections it adds to the program
+        bool validated = false;
+        std::vector<ValidationError> validation_errors;
+
+        uint32_t end() const noexcept { return offset + length; }
+    };
+
+    // Cuts [begin, end) of the text into chunks (begin is the start of a
+    // chunk, on line first_line) and parses them on up to threads threads. If the text at end is
+    // inside a string or a comment, the cut goes on over the old chunks from
+    // next_chunk on, which are then replaced too: next_chunk is left at the
+    // first old chunk to keep.
+    std::vector<Chunk> parse_range(uint32_t begin, uint32_t end, uint32_t first_line, size_t& next_chunk,
+                                   unsigned threads);
+    Chunk parse_chunk(uint32_t offset, uint32_t length) const;
+
+    // Gathers the sections and imports of all chunks into program
+    void link_sections();
+    // First failure of a chunk, 0 if all of them parse
+    int get_parse_result() const noexcept;
+
+    std::string source_path;
+    std::vector<std::string> only_sections;
+    std::string text;
+    std::vector<Chunk> chunks;
+    ProgramDeclaration program;
+    std::vector<std::shared_ptr<const Module>> imports;
+    size_t reparsed_bytes = 0;
+};
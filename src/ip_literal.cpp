@@ -0,0 +1,320 @@
+#include "ip_literal.hpp"
+
+// Reads a decimal number of at most max_digits digits starting at pos,
+// rejecting leading zeros. Advances pos past the digits on success.
+static bool read_decimal(std::string_view text, size_t& pos, int max_digits, unsigned& value) noexcept
+{
+    size_t start = pos;
+    value = 0;
+    while (pos < text.size() && pos - start < static_cast<size_t>(max_digits) &&
+           text[pos] >= '0' && text[pos] <= '9') {
+        value = value * 10 + static_cast<unsigned>(text[pos] - '0');
+        ++pos;
+    }
+    if (pos == start) {
+        return false;
+    }
+    // "0" is fine, "01" is not
+    return !(text[start] == '0' && pos - start > 1);
+}
+
+// Reads a dotted quad starting at pos
+static bool read_ipv4(std::string_view text, size_t& pos, uint32_t& address) noexcept
+{
+    address = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (i > 0) {
+            if (pos >= text.size() || text[pos] != '.') {
+                return false;
+            }
+            ++pos;
+        }
+        unsigned octet;
+        if (!read_decimal(text, pos, 3, octet) || octet > 255) {
+            return false;
+        }
+        address = (address << 8) | octet;
+    }
+    return true;
+}
+
+// Reads "/length" starting at pos
+static bool read_prefix_length(std::string_view text, size_t& pos, uint8_t& length) noexcept
+{
+    if (pos >= text.size() || text[pos] != '/') {
+        return false;
+    }
+    ++pos;
+    unsigned value;
+    if (!read_decimal(text, pos, 2, value) || value > 32) {
+        return false;
+    }
+    length = static_cast<uint8_t>(value);
+    return true;
+}
+
+bool decode_ipv4(std::string_view text, uint32_t& address) noexcept
+{
+    size_t pos = 0;
+    return read_ipv4(text, pos, address) && pos == text.size();
+}
+
+bool decode_ipv4_prefix(std::string_view text, IPv4Prefix& prefix) noexcept
+{
+    size_t pos = 0;
+    return read_ipv4(text, pos, prefix.address) &&
+           read_prefix_length(text, pos, prefix.length) &&
+           pos == text.size();
+}
+
+bool decode_ipv4_range(std::string_view text, IPv4Range& range) noexcept
+{
+    size_t pos = 0;
+    if (!read_ipv4(text, pos, range.first)) {
+        return false;
+    }
+    if (pos >= text.size() || text[pos] != '-') {
+        return false;
+    }
+    ++pos;
+    return read_ipv4(text, pos, range.last) && pos == text.size();
+}
+
+bool decode_ipv4_address_or_prefix(std::string_view text, IPv4Prefix& prefix) noexcept
+{
+    size_t pos = 0;
+    if (!read_ipv4(text, pos, prefix.address)) {
+        return false;
+    }
+    prefix.length = 32;
+    if (pos == text.size()) {
+        return true;
+    }
+    return read_prefix_length(text, pos, prefix.length) && pos == text.size();
+}
+
+std::string format_ipv4(uint32_t address)
+{
+    char buffer[16];
+    char* out = buffer;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        unsigned octet = (address >> shift) & 0xFF;
+        if (octet >= 100) {
+            *out++ = static_cast<char>('0' + octet / 100);
+        }
+        if (octet >= 10) {
+            *out++ = static_cast<char>('0' + (octet / 10) % 10);
+        }
+        *out++ = static_cast<char>('0' + octet % 10);
+        if (shift > 0) {
+            *out++ = '.';
+        }
+    }
+    return std::string(buffer, out - buffer);
+}
+
+std::string format_ipv4_prefix(const IPv4Prefix& prefix)
+{
+    return format_ipv4(prefix.address) + "/" + std::to_string(prefix.length);
+}
+
+std::string format_ipv4_range(const IPv4Range& range)
+{
+    return format_ipv4(range.first) + "-" + format_ipv4(range.last);
+}
+
+static int hex_digit_value(char c) noexcept
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Reads a group of 1-4 hex digits starting at pos
+static bool read_hex_group(std::string_view text, size_t& pos, uint16_t& group) noexcept
+{
+    size_t start = pos;
+    group = 0;
+    int digit;
+    while (pos < text.size() && pos - start < 4 && (digit = hex_digit_value(text[pos])) >= 0) {
+        group = static_cast<uint16_t>((group << 4) | digit);
+        ++pos;
+    }
+    return pos > start;
+}
+
+size_t scan_ipv6(std::string_view text, IPv6Address& address) noexcept
+{
+    uint16_t groups[8];
+    int count = 0;          // Groups read so far
+    int gap = -1;           // Index of the group where "::" was found
+    size_t pos = 0;
+
+    // Longest valid prefix seen so far
+    size_t best_end = 0;
+    int best_count = 0;
+    int best_gap = -1;
+
+    auto mark_valid = [&]() {
+        // Without "::" all 8 groups are needed, "::" stands for at least one
+        if ((gap < 0 && count == 8) || (gap >= 0 && count <= 7)) {
+            best_end = pos;
+            best_count = count;
+            best_gap = gap;
+        }
+    };
+
+    if (text.substr(0, 2) == "::") {
+        gap = 0;
+        pos = 2;
+        mark_valid();
+    }
+
+    while (count < 8) {
+        uint16_t group;
+        if (!read_hex_group(text, pos, group)) {
+            break;
+        }
+        groups[count++] = group;
+        mark_valid();
+
+        if (count == 8 || pos >= text.size() || text[pos] != ':') {
+            break;
+        }
+        if (pos + 1 < text.size() && text[pos + 1] == ':') {
+            if (gap >= 0) {
+                break; // A second "::" is never valid
+            }
+            gap = count;
+            pos += 2;
+            mark_valid();
+        } else {
+            ++pos;
+        }
+    }
+
+    if (best_end == 0) {
+        return 0;
+    }
+
+    // Expand: groups before the gap go first, the ones after it go last
+    uint16_t expanded[8] = {0};
+    if (best_gap < 0) {
+        for (int i = 0; i < 8; ++i) expanded[i] = groups[i];
+    } else {
+        int tail = best_count - best_gap;
+        for (int i = 0; i < best_gap; ++i) expanded[i] = groups[i];
+        for (int i = 0; i < tail; ++i) expanded[8 - tail + i] = groups[best_gap + i];
+    }
+    for (int i = 0; i < 8; ++i) {
+        address.bytes[2 * i] = static_cast<uint8_t>(expanded[i] >> 8);
+        address.bytes[2 * i + 1] = static_cast<uint8_t>(expanded[i] & 0xFF);
+    }
+    return best_end;
+}
+
+size_t scan_ipv6_prefix_length(std::string_view text, size_t pos, uint8_t& length) noexcept
+{
+    if (pos >= text.size() || text[pos] != '/') {
+        return 0;
+    }
+    size_t end = pos + 1;
+    unsigned value = 0;
+    // Longest valid prefix: "/129" reads as "/12", "/05" as "/0"
+    while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+        unsigned next = value * 10 + static_cast<unsigned>(text[end] - '0');
+        if (next > 128 || (end > pos + 1 && value == 0)) {
+            break;
+        }
+        value = next;
+        ++end;
+    }
+    if (end == pos + 1) {
+        return 0;
+    }
+    length = static_cast<uint8_t>(value);
+    return end - pos;
+}
+
+bool decode_ipv6(std::string_view text, IPv6Address& address) noexcept
+{
+    return !text.empty() && scan_ipv6(text, address) == text.size();
+}
+
+bool decode_ipv6_prefix(std::string_view text, IPv6Prefix& prefix) noexcept
+{
+    size_t end = scan_ipv6(text, prefix.address);
+    if (end == 0) {
+        return false;
+    }
+    size_t length_chars = scan_ipv6_prefix_length(text, end, prefix.length);
+    return length_chars > 0 && end + length_chars == text.size();
+}
+
+bool decode_ipv6_range(std::string_view text, IPv6Range& range) noexcept
+{
+    size_t end = scan_ipv6(text, range.first);
+    if (end == 0 || end >= text.size() || text[end] != '-') {
+        return false;
+    }
+    return decode_ipv6(text.substr(end + 1), range.last);
+}
+
+std::string format_ipv6(const IPv6Address& address)
+{
+    uint16_t groups[8];
+    for (int i = 0; i < 8; ++i) {
+        groups[i] = static_cast<uint16_t>((address.bytes[2 * i] << 8) | address.bytes[2 * i + 1]);
+    }
+
+    // Find the first longest run of zero groups (only runs of 2+ are compressed)
+    int best_start = -1;
+    int best_length = 1;
+    for (int i = 0; i < 8;) {
+        if (groups[i] != 0) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i < 8 && groups[i] == 0) ++i;
+        if (i - start > best_length) {
+            best_start = start;
+            best_length = i - start;
+        }
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    std::string result;
+    result.reserve(39);
+    for (int i = 0; i < 8; ++i) {
+        if (i == best_start) {
+            result += "::";
+            i += best_length - 1;
+            continue;
+        }
+        if (i > 0 && i != best_start + best_length) {
+            result += ':';
+        }
+        bool leading = true;
+        for (int shift = 12; shift >= 0; shift -= 4) {
+            int digit = (groups[i] >> shift) & 0xF;
+            if (leading && digit == 0 && shift > 0) {
+                continue;
+            }
+            leading = false;
+            result += digits[digit];
+        }
+    }
+    return result;
+}
+
+std::string format_ipv6_prefix(const IPv6Prefix& prefix)
+{
+    return format_ipv6(prefix.address) + "/" + std::to_string(prefix.length);
+}
+
+std::string format_ipv6_range(const IPv6Range& range)
+{
+    return format_ipv6(range.first) + "-" + format_ipv6(range.last);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Decoded IP literals. Plain structs so the scanner can hand them to the
+// parser through the bison %union. IPv4 addresses are in host byte order,
+// IPv6 addresses are 16 bytes in network byte order.
+
+// Address with prefix length (192.168.1.1/24); a bare address has length 32
+struct IPv4Prefix
+{
+    uint32_t address;
+    uint8_t length;
+};
+
+// Inclusive address range (10.0.0.10-10.0.0.20)
+struct IPv4Range
+{
+    uint32_t first;
+    uint32_t last;
+};
+
+// 128-bit IPv6 address
+struct IPv6Address
+{
+    uint8_t bytes[16];
+};
+
+// IPv6 address with prefix length (2001:db8::/32)
+struct IPv6Prefix
+{
+    IPv6Address address;
+    uint8_t length;
+};
+
+// Inclusive IPv6 address range (2001:db8::1-2001:db8::ff)
+struct IPv6Range
+{
+    IPv6Address first;
+    IPv6Address last;
+};
+
+// Strict decoders: dotted quad with octets 0-255 and no leading zeros,
+// prefix length 0-32. Return false if text is not exactly such a literal.
+bool decode_ipv4(std::string_view text, uint32_t& address) noexcept;
+bool decode_ipv4_prefix(std::string_view text, IPv4Prefix& prefix) noexcept;
+bool decode_ipv4_range(std::string_view text, IPv4Range& range) noexcept;
+
+// Same as decode_ipv4_prefix, the "/length" part is optional
+bool decode_ipv4_address_or_prefix(std::string_view text, IPv4Prefix& prefix) noexcept;
+
+// IPv6 recognizers used by the scanner: decode the longest prefix of text
+// that is a valid IPv6 address (RFC 4291 hex groups, at most one "::"), or
+// a prefix length of 0-128 right after a '/' at text[pos]. They return the
+// number of characters consumed, 0 if there is no valid prefix.
+size_t scan_ipv6(std::string_view text, IPv6Address& address) noexcept;
+size_t scan_ipv6_prefix_length(std::string_view text, size_t pos, uint8_t& length) noexcept;
+
+// Strict IPv6 decoders, text must be exactly the literal
+bool decode_ipv6(std::string_view text, IPv6Address& address) noexcept;
+bool decode_ipv6_prefix(std::string_view text, IPv6Prefix& prefix) noexcept;
+bool decode_ipv6_range(std::string_view text, IPv6Range& range) noexcept;
+
+// Dotted-quad text of an address ("192.168.1.1")
+std::string format_ipv4(uint32_t address);
+std::string format_ipv4_prefix(const IPv4Prefix& prefix);
+std::string format_ipv4_range(const IPv4Range& range);
+
+// Canonical RFC 5952 text of an IPv6 address: lowercase, no leading zeros,
+// the longest run of two or more zero groups written as "::"
+std::string format_ipv6(const IPv6Address& address);
+std::string format_ipv6_prefix(const IPv6Prefix& prefix);
+std::string format_ipv6_range(const IPv6Range& range);
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "parser.tab.h"
+
+// Keyword table of both lexer backends, built from keywords.def: a perfect
+// hash computed at compile time. The hand-written lexer and the word rules
+// of scanner.flex look every word up here, so the two cannot disagree on
+// which words are keywords.
+struct Keyword
+{
+    std::string_view text;
+    int token;
+};
+
+inline constexpr Keyword keywords[] = {
+#define NETFORGE_KEYWORD(text, token) {text, token},
+#include "keywords.def"
+#undef NETFORGE_KEYWORD
+};
+
+inline constexpr size_t keyword_count = sizeof(keywords) / sizeof(keywords[0]);
+inline constexpr size_t keyword_slots = 512; // Power of two, about 8x the keyword count
+
+constexpr size_t longest_keyword()
+{
+    size_t longest = 0;
+    for (const Keyword& keyword : keywords) {
+        if (keyword.text.size() > longest) longest = keyword.text.size();
+    }
+    return longest;
+}
+
+inline constexpr size_t max_keyword_length = longest_keyword();
+
+// FNV-1a variant with a seed, chosen at compile time so that no two
+// keywords share a slot
+constexpr uint32_t keyword_hash(std::string_view text, uint32_t seed)
+{
+    uint32_t hash = seed ^ static_cast<uint32_t>(text.size());
+    for (char c : text) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+// Perfect hash: slots hold the keyword index + 1, 0 marks an empty slot
+struct KeywordTable
+{
+    uint32_t seed;
+    uint8_t slots[keyword_slots];
+};
+
+constexpr KeywordTable build_keyword_table()
+{
+    KeywordTable table{};
+    for (uint32_t seed = 1; ; ++seed) {
+        for (uint8_t& slot : table.slots) slot = 0;
+
+        bool collision = false;
+        for (size_t i = 0; i < keyword_count && !collision; ++i) {
+            uint8_t& slot = table.slots[keyword_hash(keywords[i].text, seed) & (keyword_slots - 1)];
+            if (slot != 0) {
+                collision = true;
+            } else {
+                slot = static_cast<uint8_t>(i + 1);
+            }
+        }
+
+        if (!collision) {
+            table.seed = seed;
+            return table;
+        }
+    }
+}
+
+static_assert(keyword_count < 255, "keyword index must fit in a slot");
+inline constexpr KeywordTable keyword_table = build_keyword_table();
+
+// Token of a keyword spelled exactly like text, 0 if it is not a keyword
+inline int lookup_keyword(std::string_view text) noexcept
+{
+    if (text.size() > max_keyword_length) {
+        return 0;
+    }
+    uint8_t slot = keyword_table.slots[keyword_hash(text, keyword_table.seed) & (keyword_slots - 1)];
+    if (slot != 0 && keywords[slot - 1].text == text) {
+        return keywords[slot - 1].token;
+    }
+    return 0;
+}
+
+// text is a word of word characters, a '-' and more word characters.
+// Keywords like "dst-port" win over the word before the '-', even when more
+// word characters follow ("dst-portal" is dst-port al): the length of the
+// longest keyword text starts with (its token in token), 0 if there is none.
+inline size_t match_hyphenated_keyword(std::string_view text, size_t word, int& token) noexcept
+{
+    for (size_t length = text.size(); length > word + 1; --length) {
+        token = lookup_keyword(text.substr(0, length));
+        if (token != 0) {
+            return length;
+        }
+    }
+    return 0;
+}
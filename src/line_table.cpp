@@ -0,0 +1,90 @@
+#include "line_table.hpp"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Length of the [ \t\r] run at p
+static size_t leading_whitespace(const char* p, const char* end) noexcept
+{
+    const char* q = p;
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    while (q + 16 <= end) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                                     _mm_cmpeq_epi8(block, carriage_return));
+        unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & 0xFFFF;
+        if (other != 0) {
+            return (q - p) + __builtin_ctz(other);
+        }
+        q += 16;
+    }
+#endif
+    while (q < end && (*q == ' ' || *q == '\t' || *q == '\r')) ++q;
+    return q - p;
+}
+
+// Next '\n' at or after p, or end
+static const char* find_newline(const char* p, const char* end) noexcept
+{
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (p + 16 <= end) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+    const char* found = static_cast<const char*>(memchr(p, '\n', end - p));
+    return found ? found : end;
+}
+
+void LineTable::build(const char* data, size_t size)
+{
+    lines.clear();
+    // Generated configs average well over 16 bytes per line
+    lines.reserve(size / 24 + 1);
+
+    const char* end = data + size;
+    const char* line = data;
+    for (;;) {
+        size_t indent = leading_whitespace(line, end);
+        const char* first = line + indent;
+
+        LineInfo info;
+        info.offset = static_cast<uint32_t>(line - data);
+        info.indent = static_cast<uint32_t>(indent);
+        info.blank = first == end || *first == '\n' || *first == '#';
+        lines.push_back(info);
+
+        const char* newline = find_newline(first, end);
+        if (newline == end) {
+            break;
+        }
+        line = newline + 1;
+    }
+}
+
+void LineTable::clear() noexcept
+{
+    lines.clear();
+}
+
+const std::vector<LineInfo>& LineTable::get_lines() const noexcept
+{
+    return lines;
+}
+
+size_t LineTable::find_line(uint32_t offset, size_t& hint) const noexcept
+{
+    while (hint < lines.size() && lines[hint].offset < offset) ++hint;
+    return hint;
+}
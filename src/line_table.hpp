@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One source line as seen by the indentation rules
+struct LineInfo
+{
+    uint32_t offset;        // Start of the line in the input
+    uint32_t indent : 31;   // Length of the leading [ \t\r] run
+    uint32_t blank : 1;     // Nothing but whitespace and/or a # comment
+};
+
+// Line and indentation pre-scan of a whole input. Newlines and leading
+// whitespace are found 16 bytes at a time (SSE2 where available), so the
+// lexer can jump from line to line instead of scanning indentation bytes.
+class LineTable
+{
+public:
+    // Largest input the table can describe (offsets are 32-bit)
+    static constexpr size_t max_input_size = UINT32_MAX;
+
+    void build(const char* data, size_t size);
+    void clear() noexcept;
+
+    const std::vector<LineInfo>& get_lines() const noexcept;
+
+    // Index of the line starting at offset; lines must be looked up in
+    // increasing offset order, starting at hint (updated for the next call)
+    size_t find_line(uint32_t offset, size_t& hint) const noexcept;
+
+private:
+    std::vector<LineInfo> lines;
+};
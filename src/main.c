@@ -1,142 +1,526 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include "datatype.hpp"
 #include "declaration.hpp"
 #include "expression.hpp"
 #include "statement.hpp"
 #include "specialized_sections.hpp"
-
-extern FILE* yyin;
-extern int yyparse();
-extern int line_number;
-extern int yydebug;
-extern ProgramDeclaration* parser_result;
+#include "parser_context.hpp"
+#include "module_cache.hpp"
+#include "incremental.hpp"
+#include "ast_cache.hpp"
 
 void usage(char* argv[]) {
-    printf("Usage: %s input_file [output_file]\n", argv[0]);
-    printf("       If output_file is not specified, it will be input_file.rsc\n");
+    fprintf(stderr, "Usage: %s [-j threads] [--only section[,section...]] input_file [output_file]\n", argv[0]);
+    fprintf(stderr, "       If output_file is not specified, it will be input_file.rsc\n");
+    fprintf(stderr, "       Use - to read from stdin or write to stdout; stdin input\n");
+    fprintf(stderr, "       without output_file is written to stdout\n");
+    fprintf(stderr, "       -j parses the top-level sections on up to threads threads\n");
+    fprintf(stderr, "       An input with several documents (\"---\" lines between them)\n");
+    fprintf(stderr, "       gives one script per document, named after its hostname, in\n");
+    fprintf(stderr, "       the output directory (the input's by default) or on stdout\n");
+    fprintf(stderr, "       --only compiles the given top-level sections (e.g. firewall),\n");
+    fprintf(stderr, "       the others are skipped without being parsed\n");
+    fprintf(stderr, "       The AST is cached next to the output (output_file without .rsc\n");
+    fprintf(stderr, "       plus .astc) and reused while the input is unchanged;\n");
+    fprintf(stderr, "       NO_AST_CACHE=1 parses it again\n");
+    fprintf(stderr, "       NETFORGE_CACHE_DIR=dir keeps the ASTs of imported files in dir\n");
+    fprintf(stderr, "       for the next compilations\n");
     exit(1);
 }
 
-// Perform semantic analysis on the AST
-bool validate_semantics(ProgramDeclaration* program) {
-    bool valid = true;
-    std::vector<std::string> validation_errors;
-    
-    // Option to disable validation during debugging
-    bool skip_validation = false;
-    
-    // Check if there's an environment variable to skip validation
+// Option to disable validation during debugging: SKIP_VALIDATION=1
+bool validation_disabled() {
     const char* skip_env = getenv("SKIP_VALIDATION");
     if (skip_env && (strcmp(skip_env, "1") == 0 || strcmp(skip_env, "true") == 0)) {
-        printf("Warning: Skipping semantic validation due to SKIP_VALIDATION environment variable\n");
+        fprintf(stderr, "Warning: Skipping semantic validation due to SKIP_VALIDATION environment variable\n");
         return true;
     }
-    
-    // Validate each section in the program
-    for (const auto* section : program->get_sections()) {
-        // Check if this is a specialized section
-        const SpecializedSection* specialized = dynamic_cast<const SpecializedSection*>(section);
-        if (specialized) {
-            try {
-                // Call the validate method
-                auto [is_valid, error_message] = specialized->validate();
-                if (!is_valid) {
-                    valid = false;
-                    validation_errors.push_back("Error in section '" + specialized->get_name() + "': " + error_message);
-                }
-            } catch (const std::exception& e) {
-                valid = false;
-                validation_errors.push_back("Exception in section '" + specialized->get_name() + "': " + e.what());
-            } catch (...) {
-                valid = false;
-                validation_errors.push_back("Unknown error in section '" + specialized->get_name() + "'");
-            }
+    return false;
+}
+
+// Option to parse every input again, ignoring the AST cache: NO_AST_CACHE=1
+bool ast_cache_disabled() {
+    const char* no_cache_env = getenv("NO_AST_CACHE");
+    return no_cache_env && (strcmp(no_cache_env, "1") == 0 || strcmp(no_cache_env, "true") == 0);
+}
+
+// AST cache for compiling a file to output_filename, "" if there is none:
+// stdin has no file to compare with the next time, and --only builds a
+// partial AST
+std::string cache_path_for(bool input_is_stdin, const std::string& output_filename,
+                           const std::vector<std::string>& only_sections) {
+    if (input_is_stdin || !only_sections.empty() || ast_cache_disabled()) {
+        return std::string();
+    }
+    return ast_cache_path(output_filename);
+}
+
+// Loads the AST cached for a source with source_hash into a fresh ctx
+bool load_cached_ast(ParserContext& ctx, const std::string& cache_path, uint64_t source_hash) {
+    if (cache_path.empty() || !load_ast_cache(ctx, cache_path, source_hash)) {
+        return false;
+    }
+    fprintf(stderr, "Source unchanged, AST loaded from %s\n", cache_path.c_str());
+    return true;
+}
+
+// Keeps the AST of a program that parsed for the next compilation. Programs
+// with imports are not cached (the hash does not cover the imported files),
+// and neither are inputs with several documents.
+void save_cached_ast(const std::string& cache_path, const ProgramDeclaration* program, const LineIndex& line_index,
+                     uint64_t source_hash) {
+    if (!cache_path.empty() && program != nullptr) {
+        write_ast_cache(cache_path, *program, line_index, source_hash);
+    }
+}
+
+void report_validation_errors(const std::vector<std::string>& validation_errors) {
+    fprintf(stderr, "Semantic validation failed with the following errors:\n");
+    for (const auto& error : validation_errors) {
+        fprintf(stderr, "- %s\n", error.c_str());
+    }
+}
+
+// Semantic errors of a document, formatted; they are located through the
+// line index the scanner built. Imported sections were validated once, when
+// their module was loaded; their errors are taken from the module.
+std::vector<std::string> validate_document(const Document& document, const LineIndex& line_index) {
+    std::vector<std::string> validation_errors;
+
+    // Validate each section of the program itself
+    const auto& sections = document.program->get_sections();
+    for (size_t i = 0; i < sections.size(); ++i) {
+        std::string error_message;
+        if (!document.program->get_section_module(i) && !validate_section(sections[i], line_index, error_message)) {
+            validation_errors.push_back(error_message);
         }
     }
-    
+
+    for (const auto& module : document.imports) {
+        for (const auto& error : module->validation_errors) {
+            validation_errors.push_back(module->path + ": " + error);
+        }
+    }
+    return validation_errors;
+}
+
+// Perform semantic analysis on the AST of a single document
+bool validate_semantics(const Document& document, const LineIndex& line_index) {
+    if (validation_disabled()) {
+        return true;
+    }
+
+    std::vector<std::string> validation_errors = validate_document(document, line_index);
+
     // Display validation errors if any
+    if (!validation_errors.empty()) {
+        report_validation_errors(validation_errors);
+        return false;
+    }
+    return true;
+}
+
+// Same for a program parsed in chunks
+bool validate_semantics(IncrementalProgram& program) {
+    if (validation_disabled()) {
+        return true;
+    }
+    std::vector<std::string> validation_errors;
+    bool valid = program.validate(validation_errors);
     if (!valid) {
-        printf("Semantic validation failed with the following errors:\n");
-        for (const auto& error : validation_errors) {
-            printf("- %s\n", error.c_str());
-        }
+        report_validation_errors(validation_errors);
     }
-    
     return valid;
 }
 
-int main(int argc, char* argv[]) {
-    if (argc < 2 || argc > 3) {
-        usage(argv);
+// Print every syntax error the parser collected. Long lists of expected
+// tokens (e.g. any value) are left out, they would not help.
+void report_syntax_errors(const std::vector<SyntaxError>& errors, const LineIndex& line_index) {
+    const size_t max_expected = 5;
+
+    for (const auto& error : errors) {
+        SourcePosition position = line_index.position(error.span.offset);
+        std::string message = error.message;
+        if (!error.expected.empty() && error.expected.size() <= max_expected) {
+            message += ", expecting ";
+            for (size_t i = 0; i < error.expected.size(); ++i) {
+                if (i > 0) {
+                    message += i + 1 == error.expected.size() ? " or " : ", ";
+                }
+                message += error.expected[i];
+            }
+        }
+        fprintf(stderr, "Parse error at line %u, column %u: %s\n", position.line, position.column, message.c_str());
     }
+}
 
-    yyin = fopen(argv[1], "r");
+// Generate the RouterOS script of a validated program, each section is
+// written as soon as it is generated
+void write_script(const ProgramDeclaration* program, const std::string& output_filename) {
+    fprintf(stderr, "Semantic validation passed. Generating RouterOS script...\n");
 
-    if (!yyin) {
-        printf("Could not open %s\n", argv[1]);
-        exit(1);
+    if (output_filename == "-") {
+        program->write_mikrotik(std::cout, "");
+        if (!std::cout) {
+            fprintf(stderr, "Error: Could not write to stdout\n");
+        }
+    } else {
+        std::ofstream output_file(output_filename);
+        if (output_file.is_open()) {
+            program->write_mikrotik(output_file, "");
+            output_file.close();
+            
+            fprintf(stderr, "RouterOS script successfully written to %s\n", output_filename.c_str());
+        } else {
+            fprintf(stderr, "Error: Could not open output file %s\n", output_filename.c_str());
+        }
+    }
+}
+
+// Where the scripts of a multi-document input go: the output argument, a
+// directory or - for stdout; by default the directory of the input file
+// (stdout for stdin). "" if the output argument is not a directory.
+std::string documents_output(const char* input_path, const char* output_arg) {
+    if (output_arg != nullptr) {
+        struct stat status;
+        if (strcmp(output_arg, "-") != 0 && (stat(output_arg, &status) != 0 || !S_ISDIR(status.st_mode))) {
+            return "";
+        }
+        return output_arg;
+    }
+    if (strcmp(input_path, "-") == 0) {
+        return "-";
+    }
+    const char* slash = strrchr(input_path, '/');
+    return slash ? std::string(input_path, slash - input_path + 1) : std::string("./");
+}
+
+// A hostname can name a script file if it stays in the output directory
+// and is not hidden: no path separator or control character, no leading dot
+bool is_safe_file_name(const std::string& name) {
+    if (name.empty() || name.front() == '.') {
+        return false;
+    }
+    for (char c : name) {
+        if (c == '/' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// File name of each document's script: the hostname of its device section
+// (or system section, whichever sets one first)
+// ("document<N>" without one or when the hostname is not a safe file name,
+// with "-<N>" appended to a hostname taken before)
+std::vector<std::string> document_names(const std::vector<Document>& documents) {
+    std::vector<std::string> names;
+    std::set<std::string> taken;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        std::string name;
+        for (const SectionStatement* section : documents[i].program->get_sections()) {
+            // System sections are device sections too: the first hostname set wins
+            const DeviceSection* device = node_cast<DeviceSection>(section);
+            if (device && name.empty()) {
+                name = device->get_hostname();
+            }
+        }
+        if (!name.empty() && !is_safe_file_name(name)) {
+            fprintf(stderr, "Warning: hostname '%s' of document %zu is not a safe file name, its script is named document%zu\n",
+                    name.c_str(), i + 1, i + 1);
+            name.clear();
+        }
+        if (name.empty()) {
+            name = "document" + std::to_string(i + 1);
+        }
+        if (!taken.insert(name).second) {
+            name += "-" + std::to_string(i + 1);
+            taken.insert(name);
+        }
+        names.push_back(name);
+    }
+    return names;
+}
+
+// Compile every document of a multi-document input, validation and code
+// generation on up to threads threads at once; the scripts are written and
+// the errors reported in input order
+int compile_documents(const ParserContext& ctx, const char* input_path, const char* output_arg, unsigned threads) {
+    std::string output = documents_output(input_path, output_arg);
+    if (output.empty()) {
+        fprintf(stderr, "Error: %s is not a directory; the %zu documents of %s are written to one file each\n",
+                output_arg, ctx.documents.size(), input_path);
+        return 1;
+    }
+    if (output != "-" && output.back() != '/') {
+        output += '/';
     }
 
+    struct Result {
+        std::vector<std::string> errors;
+        std::string script;
+    };
+    const std::vector<Document>& documents = ctx.documents;
+    std::vector<Result> results(documents.size());
+    bool skip_validation = validation_disabled();
 
-    /* Enable parser debugging if needed */
-    // yydebug = 1;
-    
-    int parse_result = yyparse();
+    // Documents are handed out one at a time, the AST is only read
+    std::atomic<size_t> next_document{0};
+    auto compile = [&]() {
+        for (size_t i = next_document++; i < documents.size(); i = next_document++) {
+            if (!skip_validation) {
+                results[i].errors = validate_document(documents[i], ctx.line_index);
+            }
+            if (results[i].errors.empty()) {
+                results[i].script = documents[i].program->to_mikrotik("");
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < std::min<size_t>(std::max(threads, 1u), documents.size()); ++i) {
+        workers.emplace_back(compile);
+    }
+    compile();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
 
-    if (parse_result == 0) {
-  
-        // Generate output filename from input if not provided
-        char output_filename[256];
-        if (argc == 3) {
-            strncpy(output_filename, argv[2], sizeof(output_filename) - 1);
-            output_filename[sizeof(output_filename) - 1] = '\0';
+    std::vector<std::string> names = document_names(documents);
+    size_t compiled = 0;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (!results[i].errors.empty()) {
+            fprintf(stderr, "Document %zu (%s): ", i + 1, names[i].c_str());
+            report_validation_errors(results[i].errors);
+        } else if (output == "-") {
+            std::cout << "# Document " << i + 1 << ": " << names[i] << "\n" << results[i].script;
+            ++compiled;
         } else {
-            snprintf(output_filename, sizeof(output_filename), "%s.rsc", argv[1]);
-        }
-        
-        // Check if the AST was successfully built
-        if (parser_result) {
-            // Perform semantic validation before generating code
-            if (validate_semantics(parser_result)) {
-                // Validation passed, generate code
-                printf("Semantic validation passed. Generating RouterOS script...\n");
-                
-                // Open output file for writing
-                std::ofstream output_file(output_filename);
-                if (output_file.is_open()) {
-                    // Get the translated script as a string
-                    std::string routeros_script = parser_result->to_mikrotik("");
-                    
-                    // Write to the output file
-                    output_file << routeros_script;
-                    output_file.close();
-                    
-                    printf("RouterOS script successfully written to %s\n", output_filename);
-                } else {
-                    printf("Error: Could not open output file %s\n", output_filename);
-                }
+            std::string filename = output + names[i] + ".rsc";
+            std::ofstream output_file(filename);
+            if (output_file << results[i].script) {
+                ++compiled;
             } else {
-                printf("Compilation aborted due to semantic errors.\n");
-                return 1;
+                fprintf(stderr, "Error: Could not write %s\n", filename.c_str());
+            }
+        }
+    }
+    std::cout.flush();
+    fprintf(stderr, "%zu of %zu RouterOS scripts written to %s\n", compiled, documents.size(),
+            output == "-" ? "stdout" : output.c_str());
+    return compiled == documents.size() ? 0 : 1;
+}
+
+// Report the syntax errors of a parse, or compile what it parsed: the one
+// script of a single document, or a script per document
+int finish_compile(const ParserContext& ctx, int parse_result, const char* input_path, const char* output_arg,
+                   const std::string& output_filename, unsigned threads) {
+    if (parse_result != 0) {
+        report_syntax_errors(ctx.syntax_errors, ctx.line_index);
+        fprintf(stderr, "Parse failed! The input contains %zu syntax error(s).\n", ctx.syntax_errors.size());
+        return parse_result;
+    }
+
+    // Check if the AST was successfully built
+    if (!ctx.result) {
+        fprintf(stderr, "Error: Failed to build AST during parsing.\n");
+        return parse_result;
+    }
+    if (ctx.documents.size() > 1) {
+        return compile_documents(ctx, input_path, output_arg, threads);
+    }
+
+    // Perform semantic validation before generating code
+    if (!validate_semantics(ctx.documents.front(), ctx.line_index)) {
+        fprintf(stderr, "Compilation aborted due to semantic errors.\n");
+        return 1;
+    }
+    write_script(ctx.result, output_filename);
+
+    // The AST is released with ctx
+    return parse_result;
+}
+
+// True if text may hold "---" lines. Any line starting with "---" counts,
+// even inside a string: the input is then parsed as a whole, which gives
+// the same result, only on one thread.
+bool may_have_documents(const std::string& text) {
+    return text.compare(0, 3, "---") == 0 || text.find("\n---") != std::string::npos;
+}
+
+// Compile with the top-level sections parsed on several threads. The whole
+// input is read first, it is cut at the lines starting in column 0.
+int compile_in_parallel(const char* input_path, const char* output_arg, const std::string& output_filename,
+                        unsigned threads, const std::vector<std::string>& only_sections) {
+    bool input_is_stdin = strcmp(input_path, "-") == 0;
+    FILE* input = input_is_stdin ? stdin : fopen(input_path, "r");
+    if (!input) {
+        fprintf(stderr, "Could not open %s\n", input_path);
+        exit(1);
+    }
+    std::string text;
+    char buffer[64 * 1024];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        text.append(buffer, length);
+    }
+    if (!input_is_stdin) {
+        fclose(input);
+    }
+
+    std::string cache_path = cache_path_for(input_is_stdin, output_filename, only_sections);
+    uint64_t source_hash = hash_source(text.data(), text.size());
+    {
+        ParserContext ctx;
+        if (load_cached_ast(ctx, cache_path, source_hash)) {
+            return finish_compile(ctx, 0, input_path, output_arg, output_filename, threads);
+        }
+    }
+
+    // Documents are parsed in one go, then compiled on the threads
+    if (may_have_documents(text)) {
+        ParserContext ctx;
+        if (!input_is_stdin) {
+            ctx.source_path = input_path;
+        }
+        ctx.only_sections = only_sections;
+        int parse_result = netforge_parse_buffer(ctx, text.data(), text.size());
+        if (parse_result == 0 && ctx.documents.size() == 1 && ctx.imports.empty()) {
+            save_cached_ast(cache_path, ctx.result, ctx.line_index, source_hash);
+        }
+        return finish_compile(ctx, parse_result, input_path, output_arg, output_filename, threads);
+    }
+
+    IncrementalProgram program(input_is_stdin ? "" : input_path);
+    program.set_only_sections(only_sections);
+    int parse_result = program.parse(std::move(text), threads);
+    LineIndex line_index;
+    const std::string& source = program.get_text();
+    for (size_t newline = source.find('\n'); newline != std::string::npos; newline = source.find('\n', newline + 1)) {
+        line_index.add_line(static_cast<uint32_t>(newline + 1));
+    }
+    if (parse_result != 0) {
+        std::vector<SyntaxError> errors = program.get_syntax_errors();
+        report_syntax_errors(errors, line_index);
+        fprintf(stderr, "Parse failed! The input contains %zu syntax error(s).\n", errors.size());
+        return parse_result;
+    }
+    save_cached_ast(cache_path, program.get_result(), line_index, source_hash);
+
+    if (!validate_semantics(program)) {
+        fprintf(stderr, "Compilation aborted due to semantic errors.\n");
+        return 1;
+    }
+    write_script(program.get_result(), output_filename);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Options come first: -j threads, --only sections
+    unsigned threads = 0;
+    std::vector<std::string> only_sections;
+    while (argc >= 3 && argv[1][0] == '-' && argv[1][1] != '\0') {
+        if (strcmp(argv[1], "-j") == 0) {
+            char* end = nullptr;
+            long count = strtol(argv[2], &end, 10);
+            if (*argv[2] == '\0' || *end != '\0' || count < 1) {
+                usage(argv);
+            }
+            threads = static_cast<unsigned>(count);
+        } else if (strcmp(argv[1], "--only") == 0) {
+            std::string names = argv[2];
+            for (size_t begin = 0; begin <= names.size();) {
+                size_t comma = names.find(',', begin);
+                std::string name = names.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin);
+                if (!is_section_name(name)) {
+                    fprintf(stderr, "Unknown section '%s' in --only\n", name.c_str());
+                    usage(argv);
+                }
+                only_sections.push_back(name);
+                begin = comma == std::string::npos ? names.size() + 1 : comma + 1;
             }
-            
-            // Clean up resources
-            parser_result->destroy();
-            delete parser_result;
         } else {
-            printf("Error: Failed to build AST during parsing.\n");
+            usage(argv);
         }
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    if (argc < 2 || argc > 3) {
+        usage(argv);
+    }
+
+    // "-" stands for stdin/stdout, so the compiler can sit in a pipeline
+    bool input_is_stdin = strcmp(argv[1], "-") == 0;
+
+    // Generate output filename from input if not provided (a multi-document
+    // input writes one file per document, see compile_documents)
+    const char* output_arg = argc == 3 ? argv[2] : nullptr;
+    std::string output_filename;
+    if (argc == 3) {
+        output_filename = argv[2];
+    } else if (input_is_stdin) {
+        output_filename = "-";
     } else {
-        printf("Parse failed! The input contains syntax errors.\n");
+        output_filename = std::string(argv[1]) + ".rsc";
     }
 
-    fclose(yyin);
-    
-    return parse_result;
-} 
\ No newline at end of file
+    if (threads > 0) {
+        return compile_in_parallel(argv[1], output_arg, output_filename, threads, only_sections);
+    }
+
+    // All scanner and parser state for this compilation. The AST points into
+    // the source held by the context, so ctx outlives ctx.result.
+    ParserContext ctx;
+    if (!input_is_stdin) {
+        ctx.source_path = argv[1];
+    }
+    ctx.only_sections = only_sections;
+
+    // An unchanged input is not lexed nor parsed again, its AST is loaded
+    // from the cache kept next to the output
+    std::string cache_path = cache_path_for(input_is_stdin, output_filename, only_sections);
+    uint64_t source_hash = 0;
+    if (!cache_path.empty() && !hash_source_file(argv[1], source_hash)) {
+        cache_path.clear();
+    }
+    if (load_cached_ast(ctx, cache_path, source_hash)) {
+        return finish_compile(ctx, 0, argv[1], output_arg, output_filename, threads);
+    }
+
+    int parse_result;
+    if (input_is_stdin) {
+        // Read in fixed-size chunks as the input arrives
+        parse_result = netforge_parse_file(ctx, stdin);
+    } else {
+        // Parse the memory-mapped file in place; fall back to buffered reads
+        // for inputs that cannot be mapped
+        parse_result = netforge_parse_path(ctx, argv[1]);
+        if (parse_result < 0) {
+            FILE* input = fopen(argv[1], "r");
+
+            if (!input) {
+                fprintf(stderr, "Could not open %s\n", argv[1]);
+                exit(1);
+            }
+
+            parse_result = netforge_parse_file(ctx, input);
+            fclose(input);
+        }
+    }
+
+    if (parse_result == 0 && ctx.documents.size() == 1 && ctx.imports.empty()) {
+        save_cached_ast(cache_path, ctx.result, ctx.line_index, source_hash);
+    }
+    return finish_compile(ctx, parse_result, argv[1], output_arg, output_filename, threads);
+}
@@ -0,0 +1,257 @@
+#include "module_cache.hpp"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "ast_cache.hpp"
+#include "specialized_sections.hpp"
+
+// Modules loaded by this process, by canonical path. Parsing happens
+// outside the lock: two compilations loading the same module at once both
+// parse it and the first one to finish is kept. The cache holds every
+// module imported since the process started; it is not bounded, a module
+// loaded again replaces the old one.
+static std::mutex cache_mutex;
+static std::unordered_map<std::string, std::shared_ptr<const Module>> cache;
+
+// Path of the import relative to the directory of the importing file
+static std::string resolve_import(const ParserContext& ctx, std::string_view path)
+{
+    if (path.empty() || path.front() == '/' || ctx.source_path.empty()) {
+        return std::string(path);
+    }
+    size_t slash = ctx.source_path.rfind('/');
+    if (slash == std::string::npos) {
+        return std::string(path);
+    }
+    return ctx.source_path.substr(0, slash + 1) + std::string(path);
+}
+
+static std::string canonical_path(const std::string& path)
+{
+    char resolved[PATH_MAX];
+    if (path.empty() || realpath(path.c_str(), resolved) == nullptr) {
+        return std::string();
+    }
+    return resolved;
+}
+
+// True if path is being parsed by ctx or by one of the files importing it
+static bool is_being_imported(const ParserContext& ctx, const std::string& path)
+{
+    for (const ParserContext* importer = &ctx; importer; importer = importer->importer) {
+        if (canonical_path(importer->source_path) == path) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// AST cache file of the module at path in the directory NETFORGE_CACHE_DIR,
+// named after the hash of the path; "" when the variable is not set
+static std::string module_cache_path(const std::string& path)
+{
+    const char* directory = getenv("NETFORGE_CACHE_DIR");
+    if (directory == nullptr || *directory == '\0') {
+        return std::string();
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.astc",
+             static_cast<unsigned long long>(hash_source(path.data(), path.size())));
+    return std::string(directory) + "/" + name;
+}
+
+static int parse_module(Module& module)
+{
+    int parse_result = netforge_parse_path(module.ctx, module.path.c_str());
+    if (parse_result < 0) {
+        if (FILE* input = fopen(module.path.c_str(), "r")) {
+            parse_result = netforge_parse_file(module.ctx, input);
+            fclose(input);
+        }
+    }
+    return parse_result;
+}
+
+static std::shared_ptr<const Module> load_module(const ParserContext& importer, const std::string& path,
+                                                 const struct stat& status)
+{
+    auto module = std::make_shared<Module>();
+    module->path = path;
+    module->modified = status.st_mtim;
+    module->size = status.st_size;
+    module->ctx.source_path = path;
+    module->ctx.importer = &importer;
+
+    // With a cache directory, a module parsed by an earlier process is
+    // loaded from its AST. Modules with imports are not kept there (the
+    // hash does not cover the imported files), nor are several documents.
+    std::string cache_path = module_cache_path(path);
+    uint64_t source_hash = 0;
+    int parse_result;
+    if (!cache_path.empty() && hash_source_file(path, source_hash)) {
+        if (load_ast_cache(module->ctx, cache_path, source_hash)) {
+            parse_result = 0;
+        } else {
+            parse_result = parse_module(*module);
+            if (parse_result == 0 && module->ctx.result && module->ctx.imports.empty() &&
+                module->ctx.documents.size() <= 1) {
+                write_ast_cache(cache_path, *module->ctx.result, module->ctx.line_index, source_hash);
+            }
+        }
+    } else {
+        parse_result = parse_module(*module);
+    }
+    module->ctx.importer = nullptr;
+    module->parsed = parse_result == 0 && module->ctx.result != nullptr;
+
+    // Its own sections, the ones it imports are validated with their module
+    if (module->parsed) {
+        const ProgramDeclaration* program = module->ctx.result;
+        for (size_t i = 0; i < program->get_sections().size(); ++i) {
+            std::string message;
+            if (!program->get_section_module(i) &&
+                !validate_section(program->get_sections()[i], module->ctx.line_index, message)) {
+                module->validation_errors.push_back(message);
+            }
+        }
+    }
+    return module;
+}
+
+// Compares the modification time to the nanosecond: a file rewritten with
+// the same size within a second is still seen as changed
+static bool is_unchanged(const Module& module, const struct stat& status)
+{
+    return module.modified.tv_sec == status.st_mtim.tv_sec && module.modified.tv_nsec == status.st_mtim.tv_nsec &&
+           module.size == status.st_size;
+}
+
+// True if module can be used for a file in state status: neither the file
+// nor the files it imports (module->ctx.imports holds them all, at any
+// depth) changed since it was loaded. A module that did not parse is loaded
+// again, the file it could not import may exist now.
+static bool is_current(const Module& module, const struct stat& status)
+{
+    if (!module.parsed || !is_unchanged(module, status)) {
+        return false;
+    }
+    for (const auto& dependency : module.ctx.imports) {
+        struct stat dependency_status;
+        if (stat(dependency->path.c_str(), &dependency_status) != 0 ||
+            !is_unchanged(*dependency, dependency_status)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cached module at path, loaded again when it or one of its imports changed
+static std::shared_ptr<const Module> get_module(const ParserContext& importer, const std::string& path,
+                                                const struct stat& status)
+{
+    std::shared_ptr<const Module> cached_module;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto cached = cache.find(path);
+        if (cached != cache.end()) {
+            cached_module = cached->second;
+        }
+    }
+    if (cached_module && is_current(*cached_module, status)) {
+        return cached_module;
+    }
+
+    std::shared_ptr<const Module> module = load_module(importer, path, status);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto& cached = cache[path];
+    if (cached && cached != cached_module && is_unchanged(*cached, status) && cached->parsed) {
+        return cached;
+    }
+    cached = module;
+    return module;
+}
+
+static bool is_imported(const ParserContext& ctx, const Module* module)
+{
+    for (const auto& imported : ctx.imports) {
+        if (imported.get() == module) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Splices the sections of module into ctx.result. Sections the module got
+// from its own imports are skipped when ctx already has their module, so a
+// file imported on several paths appears once, and so are the sections
+// ctx.only_sections leaves out (the module itself is parsed whole, it is
+// shared).
+static void splice_module(ParserContext& ctx, const std::shared_ptr<const Module>& module)
+{
+    if (is_imported(ctx, module.get())) {
+        return;
+    }
+    const ProgramDeclaration* program = module->ctx.result;
+    for (size_t i = 0; i < program->get_sections().size(); ++i) {
+        const Module* origin = program->get_section_module(i);
+        if (origin == nullptr) {
+            origin = module.get();
+        } else if (is_imported(ctx, origin)) {
+            continue;
+        }
+        SectionStatement* section = program->get_sections()[i];
+        if (ctx.is_section_skipped(section->get_name())) {
+            continue;
+        }
+        ctx.result->add_imported_section(section, origin);
+        if (ctx.on_section) {
+            ctx.on_section(section);
+        }
+    }
+    ctx.imports.push_back(module);
+    for (const auto& dependency : module->ctx.imports) {
+        if (!is_imported(ctx, dependency.get())) {
+            ctx.imports.push_back(dependency);
+        }
+    }
+}
+
+void netforge_import(ParserContext& ctx, std::string_view path, SourceSpan span)
+{
+    std::string resolved = canonical_path(resolve_import(ctx, path));
+    struct stat status;
+    if (resolved.empty() || stat(resolved.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+        ctx.report_syntax_error(span, "cannot open imported file \"" + std::string(path) + "\"");
+        return;
+    }
+    if (is_being_imported(ctx, resolved)) {
+        ctx.report_syntax_error(span, "\"" + std::string(path) + "\" imports itself");
+        return;
+    }
+
+    std::shared_ptr<const Module> module = get_module(ctx, resolved, status);
+    if (!module->parsed) {
+        if (module->ctx.syntax_errors.empty()) {
+            ctx.report_syntax_error(span, "imported file \"" + std::string(path) + "\" could not be parsed");
+        }
+        for (const auto& error : module->ctx.syntax_errors) {
+            SourcePosition position = module->ctx.line_index.position(error.span.offset);
+            ctx.report_syntax_error(span, "in imported file \"" + std::string(path) + "\" at line " +
+                                    std::to_string(position.line) + ", column " +
+                                    std::to_string(position.column) + ": " + error.message);
+        }
+        return;
+    }
+    if (module->ctx.documents.size() > 1) {
+        ctx.report_syntax_error(span, "imported file \"" + std::string(path) + "\" holds several documents");
+        return;
+    }
+    splice_module(ctx, module);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <time.h>
+#include <vector>
+
+#include "parser_context.hpp"
+
+// A file brought in by `import "path.dsl"`. It is parsed and validated once
+// per process and then shared, read-only, by every program importing it:
+// its sections are spliced into those programs without being copied, so a
+// module must never be modified after it has been loaded. When it or any
+// file it imports changes, the next import loads it again. With
+// NETFORGE_CACHE_DIR set, the AST of a module without imports is also kept
+// in that directory, so later processes load it instead of parsing it.
+struct Module
+{
+    std::string path;                          // Canonical path, the cache key
+    timespec modified = {};                    // File state when it was loaded;
+    off_t size = 0;                            // a changed file is loaded again
+    ParserContext ctx;                         // Source, arena and AST of the module
+    bool parsed = false;
+    std::vector<std::string> validation_errors;  // Of its own sections, formatted
+};
+
+// Handles an import directive of ctx at span: resolves path relative to the
+// importing file (ctx.source_path, the working directory for stdin), takes
+// the module from the process-wide cache or loads it, and splices its
+// sections into ctx.result. A module already spliced into this program,
+// directly or through another import, is skipped. Unreadable files, import
+// cycles and syntax errors in the module are reported as syntax errors of
+// ctx at span.
+void netforge_import(ParserContext& ctx, std::string_view path, SourceSpan span);
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "datatype.hpp"
+#include "declaration.hpp"
+#include "expression.hpp"
+#include "specialized_sections.hpp"
+#include "statement.hpp"
+
+// Calls visitor with node as its most derived class, chosen by a switch on
+// its kind tag instead of a chain of casts. The visitor must take every node
+// class: a generic lambda, or overloads where a base class (Statement,
+// Value, ...) catches the classes it does not handle one by one. All of
+// them return the same type. Datatypes are all passed as Datatype.
+template <typename Visitor>
+decltype(auto) visit_node(const ASTNodeInterface& node, Visitor&& visitor)
+{
+    switch (node.get_kind()) {
+        case NodeKind::PROPERTY_STATEMENT:
+            return visitor(static_cast<const PropertyStatement&>(node));
+        case NodeKind::BLOCK_STATEMENT:
+            return visitor(static_cast<const BlockStatement&>(node));
+        case NodeKind::DECLARATION_STATEMENT:
+            return visitor(static_cast<const DeclarationStatement&>(node));
+        case NodeKind::SECTION_STATEMENT:
+            return visitor(static_cast<const SectionStatement&>(node));
+        case NodeKind::DEVICE_SECTION:
+            return visitor(static_cast<const DeviceSection&>(node));
+        case NodeKind::SYSTEM_SECTION:
+            return visitor(static_cast<const SystemSection&>(node));
+        case NodeKind::INTERFACES_SECTION:
+            return visitor(static_cast<const InterfacesSection&>(node));
+        case NodeKind::IP_SECTION:
+            return visitor(static_cast<const IPSection&>(node));
+        case NodeKind::ROUTING_SECTION:
+            return visitor(static_cast<const RoutingSection&>(node));
+        case NodeKind::FIREWALL_SECTION:
+            return visitor(static_cast<const FirewallSection&>(node));
+        case NodeKind::CUSTOM_SECTION:
+            return visitor(static_cast<const CustomSection&>(node));
+        case NodeKind::STRING_VALUE:
+            return visitor(static_cast<const StringValue&>(node));
+        case NodeKind::NUMBER_VALUE:
+            return visitor(static_cast<const NumberValue&>(node));
+        case NodeKind::BOOLEAN_VALUE:
+            return visitor(static_cast<const BooleanValue&>(node));
+        case NodeKind::IP_ADDRESS_VALUE:
+            return visitor(static_cast<const IPAddressValue&>(node));
+        case NodeKind::IP_CIDR_VALUE:
+            return visitor(static_cast<const IPCIDRValue&>(node));
+        case NodeKind::IP_RANGE_VALUE:
+            return visitor(static_cast<const IPRangeValue&>(node));
+        case NodeKind::IPV6_ADDRESS_VALUE:
+            return visitor(static_cast<const IPv6AddressValue&>(node));
+        case NodeKind::IPV6_CIDR_VALUE:
+            return visitor(static_cast<const IPv6CIDRValue&>(node));
+        case NodeKind::IPV6_RANGE_VALUE:
+            return visitor(static_cast<const IPv6RangeValue&>(node));
+        case NodeKind::LIST_VALUE:
+            return visitor(static_cast<const ListValue&>(node));
+        case NodeKind::IDENTIFIER_EXPRESSION:
+            return visitor(static_cast<const IdentifierExpression&>(node));
+        case NodeKind::PROPERTY_REFERENCE:
+            return visitor(static_cast<const PropertyReference&>(node));
+        case NodeKind::CONFIG_DECLARATION:
+            return visitor(static_cast<const ConfigDeclaration&>(node));
+        case NodeKind::PROGRAM_DECLARATION:
+            return visitor(static_cast<const ProgramDeclaration&>(node));
+        case NodeKind::DATATYPE:
+        default:
+            return visitor(static_cast<const Datatype&>(node));
+    }
+}
+
+// Visitor made of lambdas, one per node class it handles:
+//
+//     visit_node(node, overloaded{
+//         [](const PropertyStatement& property) { ... },
+//         [](const SectionStatement& section) { ... },
+//         ignore_node{}});
+//
+// The overload of the closest base class is chosen, so SectionStatement also
+// takes every specialized section. The catch-all must name its class like
+// ignore_node does: a generic lambda would be picked for every node.
+template <typename... Visitors>
+struct overloaded : Visitors...
+{
+    using Visitors::operator()...;
+};
+
+template <typename... Visitors>
+overloaded(Visitors...) -> overloaded<Visitors...>;
+
+// Catch-all of a visitor that does nothing with the other node classes
+struct ignore_node
+{
+    void operator()(const ASTNodeInterface&) const noexcept {}
+};
+
+// Visits each statement of block in order, none if block is null
+template <typename Visitor>
+void visit_statements(const BlockStatement* block, Visitor&& visitor)
+{
+    if (block == nullptr) {
+        return;
+    }
+    for (const Statement* statement : block->get_statements()) {
+        visit_node(*statement, visitor);
+    }
+}
@@ -0,0 +1,84 @@
+#include "parser_context.hpp"
+
+#include <algorithm>
+#include "parser.tab.h"
+#include "push_parser.hpp"
+#include "module_cache.hpp"
+
+// Out of line: FeedState and Module are only complete here
+ParserContext::ParserContext() = default;
+ParserContext::~ParserContext() = default;
+
+int ParserContext::pop_queued_token()
+{
+    if (!token_queue.empty()) {
+        return token_queue.pop_front();
+    }
+    return 0;
+}
+
+void ParserContext::queue_eof_tokens()
+{
+    if (eof_handled) return;
+
+    // First add a NEWLINE if we're not at the start of a line
+    if (!at_line_start) {
+        token_queue.push_back(TOKEN_NEWLINE);
+    }
+
+    // Add DEDENT tokens to get back to indentation level 0
+    while (indent_stack.size() > 1) {  // Keep the base level 0
+        indent_stack.pop_back();
+        token_queue.push_back(TOKEN_DEDENT);
+    }
+
+    eof_handled = true;
+}
+
+int ParserContext::queue_document_separator()
+{
+    current_indent = 0;
+    while (indent_stack.size() > 1) {
+        indent_stack.pop_back();
+        token_queue.push_back(TOKEN_DEDENT);
+    }
+    token_queue.push_back(TOKEN_DOCUMENT_SEPARATOR);
+    return pop_queued_token();
+}
+
+int ParserContext::nearest_indent_above(int indent) const noexcept
+{
+    for (int level : indent_stack) {
+        if (level > indent) {
+            return level;
+        }
+    }
+    return indent_stack.back();
+}
+
+void ParserContext::report_syntax_error(SourceSpan span, std::string message,
+                                        std::vector<std::string> expected)
+{
+    syntax_errors.push_back(SyntaxError{span, std::move(message), std::move(expected)});
+}
+
+bool is_section_name(std::string_view name) noexcept
+{
+    return name == "device" || name == "interfaces" || name == "ip" || name == "routing" ||
+           name == "firewall" || name == "system";
+}
+
+bool ParserContext::is_section_skipped(std::string_view name) const noexcept
+{
+    return !only_sections.empty() && is_section_name(name) &&
+           std::find(only_sections.begin(), only_sections.end(), name) == only_sections.end();
+}
+
+void ParserContext::note_line_breaks(const char* text, size_t length, uint32_t offset)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] == '\n') {
+            line_index.add_line(offset + static_cast<uint32_t>(i) + 1);
+        }
+    }
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <stdio.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast_arena.hpp"
+#include "declaration.hpp"
+#include "source_buffer.hpp"
+#include "source_span.hpp"
+#include "symbol_table.hpp"
+#include "token_ring.hpp"
+
+// Opaque handle of a reentrant flex scanner (same guard flex itself uses)
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+// Text of an IDENTIFIER, STRING or IP token as handed to the parser.
+// A plain struct (not a std::string_view) so it can live in the bison %union.
+struct TokenText
+{
+    const char* data;
+    size_t length;
+    Symbol symbol;    // Of a keyword turned into a name, NONE for scanned text
+
+    std::string_view view() const noexcept { return std::string_view(data, length); }
+
+    // Symbol of the text as a name; scanned text is interned
+    Symbol intern() const { return symbol != Symbol::NONE ? symbol : intern_symbol(view()); }
+};
+
+// Token text for a keyword turned into a known name, with its symbol
+inline TokenText symbol_text(Symbol symbol) noexcept
+{
+    std::string_view text = known_symbol_name(symbol);
+    return TokenText{text.data(), text.size(), symbol};
+}
+
+// A syntax error: where it is, what went wrong and, when the parser found
+// an unexpected token, the tokens it would have accepted instead
+struct SyntaxError
+{
+    SourceSpan span;
+    std::string message;
+    std::vector<std::string> expected;
+};
+
+struct FeedState;
+struct Module;
+
+// True for the names of top-level sections (section_name in parser.bison)
+bool is_section_name(std::string_view name) noexcept;
+
+// One document of the input ("---" lines separate them, e.g. one device
+// each): its program and the modules spliced into it
+struct Document
+{
+    ProgramDeclaration* program = nullptr;
+    std::vector<std::shared_ptr<const Module>> imports;
+};
+
+// Per-compilation state shared by the scanner and the parser.
+// Every compilation owns its own context, so several compilations can run
+// concurrently on different threads of the same process.
+struct ParserContext
+{
+    ParserContext();
+    ~ParserContext();
+
+    // Indentation handling
+    std::vector<int> indent_stack{0}; // Start with indent level 0
+    TokenRing token_queue;            // Buffer for INDENT/DEDENT tokens
+    int current_indent = 0;
+    bool at_line_start = true;
+    bool eof_handled = false;         // Flag to track if we've handled EOF
+
+    // Position tracking. Tokens carry a SourceSpan; line_index maps its
+    // offset to line and column when a diagnostic is reported.
+    int line_number = 1;
+    uint32_t scan_offset = 0;         // End of the last token scanned
+    LineIndex line_index;
+
+    // Scanner instance and parse result. The AST lives in the arena and is
+    // freed with the context, in one step.
+    yyscan_t scanner = nullptr;
+    ProgramDeclaration* result = nullptr;
+    AstArena arena;
+
+    // File being parsed, "" for stdin; imports are resolved relative to it
+    std::string source_path;
+    // Modules spliced into result, directly or through other modules. They
+    // are shared with the module cache and kept alive by the context.
+    std::vector<std::shared_ptr<const Module>> imports;
+    // Documents of the input in order, one for an input without "---"
+    // lines; documents without any section are left out. While parsing,
+    // result and imports belong to the document being parsed; at the end
+    // they are the ones of the last document.
+    std::vector<Document> documents;
+    // Context whose import is being parsed into this one (import cycles)
+    const ParserContext* importer = nullptr;
+
+    // Top-level sections to compile (--only), empty for all of them. The
+    // lexers skip the others, their header and every line indented under
+    // it, without producing tokens: no AST is built for them.
+    std::vector<std::string> only_sections;
+    bool skipping_section = false;    // Lexer state: in a section left out
+
+    // Syntax errors in input order. The parser recovers at the end of the
+    // bad line (with any block under it), so one parse finds all of them;
+    // it fails if there is any.
+    std::vector<SyntaxError> syntax_errors;
+
+    // Called with each top-level section as soon as the parser completes
+    // it (before the rest of the input is parsed), optional
+    std::function<void(SectionStatement*)> on_section;
+
+    // False while netforge_feed() may still deliver input: the end of the
+    // scanned text is then not the end of the input (no EOF tokens)
+    bool input_complete = true;
+    // Push parser and unscanned input of netforge_feed()
+    std::unique_ptr<FeedState> feed;
+
+    // Source text. Token text and the AST built from it (property names,
+    // string values) point into the mapped file. Text that cannot point into
+    // the mapping (stream input) is copied once into the arena.
+    SourceBuffer source;
+
+    // Pending INDENT/DEDENT/NEWLINE tokens, shared by both lexer backends.
+    // pop_queued_token returns 0 when the queue is empty; queue_eof_tokens
+    // closes the last line and every open indentation level (only once).
+    int pop_queued_token();
+    void queue_eof_tokens();
+    // For a "---" line: closes every open block and queues the separator,
+    // then returns the first token queued
+    int queue_document_separator();
+
+    // Lowest open indentation level above indent. A line with an invalid
+    // dedentation is taken to be at that level, so the levels below it
+    // stay open and the following lines still match them.
+    int nearest_indent_above(int indent) const noexcept;
+
+    void report_syntax_error(SourceSpan span, std::string message,
+                             std::vector<std::string> expected = {});
+
+    // True if name is a top-level section left out by only_sections
+    bool is_section_skipped(std::string_view name) const noexcept;
+
+    // Records the lines starting after each '\n' of a token at offset
+    // (strings and comments spanning lines)
+    void note_line_breaks(const char* text, size_t length, uint32_t offset);
+
+    TokenText keep_text(const char* text, size_t length)
+    {
+        if (source.contains(text, length)) {
+            return TokenText{text, length};
+        }
+        std::string_view kept = arena.copy_text(std::string_view(text, length));
+        return TokenText{kept.data(), kept.size()};
+    }
+};
+
+// Entry points implemented by the lexer backend selected at build time
+// (scanner.flex or handwritten_lexer.cpp, see LEXER in the Makefile).
+
+// Scan and parse a whole input stream. The resulting AST is stored in
+// ctx.result; returns 0 on success like yyparse().
+int netforge_parse_file(ParserContext& ctx, FILE* input);
+
+// Memory-map the file at path and parse it in place (no copy of the input,
+// no allocation per token). Returns -1 if the file cannot be mapped, e.g.
+// for pipes and character devices; callers fall back to netforge_parse_file.
+int netforge_parse_path(ParserContext& ctx, const char* path);
+
+// Push interface for input that arrives in pieces (e.g. from a socket):
+// parsing overlaps with receiving, and on_section fires for each completed
+// top-level section. netforge_feed takes any number of bytes, cut anywhere;
+// it returns 0 while the input parses so far and the parse result (like
+// yyparse) once it has failed. netforge_finish marks the end of the input
+// and returns the final result.
+int netforge_feed(ParserContext& ctx, const char* bytes, size_t length);
+int netforge_finish(ParserContext& ctx);
+
+// Parse [data, data + length), a complete input that only has to stay
+// valid during the call (token text is copied into the arena)
+int netforge_parse_buffer(ParserContext& ctx, const char* data, size_t length);
+
+// Incremental scanning for netforge_feed, implemented by the lexer backend:
+// scan [data, data + length), which holds whole lines of the input and
+// never ends inside a string or comment, next. The data must stay valid
+// until yylex() returns 0 (end of the piece, or of the input when
+// ctx.input_complete).
+int netforge_scan_piece(ParserContext& ctx, const char* data, size_t length);
+
+// Lexer-only access, used by the lexer benchmark: map the file at path and
+// start a scanner on it (-1 if it cannot be mapped, 1 on other errors), call
+// yylex() until it returns 0, then release the scanner.
+int netforge_scan_begin(ParserContext& ctx, const char* path);
+void netforge_scan_end(ParserContext& ctx);
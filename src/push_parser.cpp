@@ -0,0 +1,147 @@
+#include "push_parser.hpp"
+
+#include "scanner.hpp"
+
+void InputCutter::advance(const std::string& text, bool input_complete) noexcept
+{
+    for (; position < text.size(); ++position) {
+        char c = text[position];
+        switch (mode) {
+            case Mode::CODE:
+                if (c == '\n') {
+                    safe_end = position + 1;
+                } else if (c == '#') {
+                    mode = Mode::LINE_COMMENT;
+                } else if (c == '"') {
+                    if (position + 2 >= text.size() && !input_complete) {
+                        return; // Wait to see whether it opens a """ comment
+                    }
+                    if (position + 2 < text.size() && text[position + 1] == '"' && text[position + 2] == '"') {
+                        mode = Mode::MULTILINE_COMMENT;
+                        quotes = 0;
+                        position += 2;
+                    } else {
+                        mode = Mode::STRING;
+                    }
+                }
+                break;
+            case Mode::LINE_COMMENT:
+                if (c == '\n') {
+                    mode = Mode::CODE;
+                    safe_end = position + 1;
+                }
+                break;
+            case Mode::STRING:
+                if (c == '"') {
+                    mode = Mode::CODE;
+                }
+                break;
+            case Mode::MULTILINE_COMMENT:
+                if (c != '"') {
+                    quotes = 0;
+                } else if (++quotes == 3) {
+                    mode = Mode::CODE;
+                }
+                break;
+        }
+    }
+}
+
+size_t InputCutter::get_safe_end() const noexcept
+{
+    return safe_end;
+}
+
+size_t InputCutter::checked() const noexcept
+{
+    return position;
+}
+
+void InputCutter::consume(size_t count) noexcept
+{
+    position -= count;
+    safe_end -= count;
+}
+
+FeedState::FeedState() : parser(yypstate_new()) {}
+
+FeedState::~FeedState()
+{
+    yypstate_delete(parser);
+}
+
+// Scans [0, length) of the pending input and pushes its tokens
+static void push_piece(ParserContext& ctx, size_t length)
+{
+    FeedState& feed = *ctx.feed;
+    if (netforge_scan_piece(ctx, feed.pending.data(), length) != 0) {
+        feed.status = 2;
+        return;
+    }
+
+    YYSTYPE value;
+    YYLTYPE location;
+    while (feed.status == YYPUSH_MORE) {
+        int token = yylex(&value, &location, &ctx);
+        if (token == 0 && !ctx.input_complete) {
+            break; // End of the piece
+        }
+        feed.status = yypush_parse(feed.parser, token, &value, &location, &ctx);
+        if (token == 0) {
+            break;
+        }
+    }
+
+    // Token text was copied out (see ParserContext::keep_text)
+    feed.pending.erase(0, length);
+    feed.cutter.consume(length);
+}
+
+int netforge_feed(ParserContext& ctx, const char* bytes, size_t length)
+{
+    if (!ctx.feed) {
+        ctx.feed = std::make_unique<FeedState>();
+        ctx.input_complete = false;
+    }
+    FeedState& feed = *ctx.feed;
+    if (feed.status != YYPUSH_MORE) {
+        return feed.status;
+    }
+
+    feed.pending.append(bytes, length);
+    feed.cutter.advance(feed.pending, false);
+    if (feed.cutter.get_safe_end() > 0) {
+        push_piece(ctx, feed.cutter.get_safe_end());
+    }
+    return feed.status == YYPUSH_MORE ? 0 : feed.status;
+}
+
+int netforge_finish(ParserContext& ctx)
+{
+    if (!ctx.feed) {
+        netforge_feed(ctx, "", 0);
+    }
+    FeedState& feed = *ctx.feed;
+    if (feed.status == YYPUSH_MORE) {
+        ctx.input_complete = true;
+        push_piece(ctx, feed.pending.size());
+    }
+
+    int status = feed.status;
+    netforge_scan_end(ctx);
+    ctx.feed.reset();
+    return status;
+}
+
+int netforge_parse_buffer(ParserContext& ctx, const char* data, size_t length)
+{
+    // One piece that is the whole input
+    ctx.input_complete = true;
+    if (netforge_scan_piece(ctx, data, length) != 0) {
+        netforge_scan_end(ctx);
+        return 2;
+    }
+    int result = yyparse(&ctx);
+    netforge_scan_end(ctx);
+    return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "parser_context.hpp"
+#include "parser.tab.h"
+
+// Finds where fed input may be cut for the scanner: right after a newline
+// that is not inside a string or a """ comment (# comments end at the
+// newline). Same lexical rules as both lexer backends, so a piece cut here
+// scans exactly like the whole input.
+class InputCutter
+{
+public:
+    // Runs over text[checked(), text.size()). Stops early at a '"' whose
+    // next two characters have not arrived yet, unless the input is complete.
+    void advance(const std::string& text, bool input_complete) noexcept;
+
+    // End of the longest prefix that can be scanned on its own
+    size_t get_safe_end() const noexcept;
+    size_t checked() const noexcept;
+
+    // The first count bytes were scanned and dropped from the text
+    void consume(size_t count) noexcept;
+
+private:
+    enum class Mode {
+        CODE,
+        LINE_COMMENT,
+        STRING,
+        MULTILINE_COMMENT
+    };
+
+    Mode mode = Mode::CODE;
+    int quotes = 0;         // Closing quotes seen in a """ comment
+    size_t position = 0;
+    size_t safe_end = 0;
+};
+
+// netforge_feed() state kept in the ParserContext
+struct FeedState
+{
+    FeedState();
+    ~FeedState();
+
+    yypstate* parser;
+    std::string pending;    // Input received and not scanned yet
+    InputCutter cutter;
+    int status = YYPUSH_MORE;
+};
@@ -1,17 +1,11 @@
 #ifndef SCANNER_HPP
 #define SCANNER_HPP
 
-#include <vector>
+#include "parser_context.hpp"
+#include "parser.tab.h"
 
-// Variables from scanner
-extern int line_number;
-extern int column_number;
-extern std::vector<int> indent_stack;
-extern std::vector<int> token_queue;
+// Scanner entry point used by the parser. All scanner state (indentation
+// stack, pending INDENT/DEDENT tokens, line tracking) lives in the context.
+extern int yylex(YYSTYPE* yylval_param, YYLTYPE* yylloc_param, ParserContext* ctx);
 
-// Function declarations
-extern int yylex();
-extern int yylex_flex();
-int check_token_queue();
-
-#endif /* SCANNER_HPP */ 
\ No newline at end of file
+#endif /* SCANNER_HPP */
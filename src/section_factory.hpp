@@ -1,12 +1,15 @@
 #pragma once
 
+#include "ast_arena.hpp"
 #include "specialized_sections.hpp"
 
 class SectionFactory {
 public:
-    // Create a specialized section based on section type
-    static SectionStatement* create_section(std::string_view name, SectionStatement::SectionType type, BlockStatement* block = nullptr) {
-        SpecializedSection* section = create_specialized_section(name, type);
+    // Create a specialized section based on section type, in the arena.
+    // symbol is the interned name, interned here if not given.
+    static SectionStatement* create_section(AstArena& arena, std::string_view name, SectionStatement::SectionType type, BlockStatement* block = nullptr, Symbol symbol = Symbol::NONE) {
+        SpecializedSection* section = create_specialized_section(arena, name, type);
+        section->set_symbol(symbol != Symbol::NONE ? symbol : intern_symbol(name));
         
         if (block) {
             section->set_block(block);
@@ -16,18 +19,18 @@ public:
     }
     
     // Create a section from an existing SectionStatement
-    static SectionStatement* create_section_from_generic(SectionStatement* generic_section) {
+    static SectionStatement* create_section_from_generic(AstArena& arena, SectionStatement* generic_section) {
         if (!generic_section) return nullptr;
         
         SpecializedSection* specialized = create_specialized_section(
+            arena,
             generic_section->get_name(), 
             generic_section->get_section_type()
         );
         
+        // The block moves to the new section, the generic one stays in the arena
         specialized->set_block(generic_section->get_block());
-        
-        // Return newly created specialized section and destroy the generic one
-        generic_section->destroy();
+        specialized->set_symbol(generic_section->get_symbol());
         
         return specialized;
     }
@@ -1,6 +1,104 @@
 #include "semantic_validator.hpp"
 #include "specialized_sections.hpp"
-#include <regex>
+#include "ip_literal.hpp"
+#include "node_visitor.hpp"
+
+#include <array>
+
+namespace {
+
+// Value types a property accepts. Quoted text is accepted wherever an
+// address or a number is, as the translators take both.
+struct PropertyTypes {
+    std::array<const Datatype*, 7> accepted{};
+
+    bool accepts(const Datatype& type) const noexcept {
+        for (const Datatype* candidate : accepted) {
+            if (candidate == &type) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string describe() const {
+        std::string names;
+        for (const Datatype* candidate : accepted) {
+            if (candidate) {
+                names += (names.empty() ? "" : " or ") + candidate->type_name();
+            }
+        }
+        return names;
+    }
+};
+
+// Types accepted by the properties known at compile time, by symbol; null
+// for a property that takes any value. Types are canonical, so checking a
+// value compares pointers and allocates nothing.
+const PropertyTypes* property_types(Symbol symbol) noexcept {
+    using Type = Datatype::Type;
+    static const auto table = [] {
+        std::array<PropertyTypes, static_cast<size_t>(Symbol::FIRST_INTERNED)> rules{};
+        const Datatype* string = &basic_datatype(Type::STRING);
+        const Datatype* number = &basic_datatype(Type::NUMBER);
+        const Datatype* ip_address = &basic_datatype(Type::IP_ADDRESS);
+        const Datatype* ip_cidr = &basic_datatype(Type::IP_CIDR);
+        const Datatype* ip_range = &basic_datatype(Type::IP_RANGE);
+        const Datatype* ipv6_address = &basic_datatype(Type::IPV6_ADDRESS);
+        const Datatype* ipv6_cidr = &basic_datatype(Type::IPV6_CIDR);
+        const Datatype* ipv6_range = &basic_datatype(Type::IPV6_RANGE);
+        const Datatype* string_list = &list_datatype(*string);
+
+        auto rule = [&](std::initializer_list<Symbol> symbols, PropertyTypes types) {
+            for (Symbol symbol : symbols) {
+                rules[static_cast<size_t>(symbol)] = types;
+            }
+        };
+        rule({Symbol::VENDOR, Symbol::MODEL, Symbol::HOSTNAME, Symbol::TYPE, Symbol::ADMIN_STATE,
+              Symbol::DESCRIPTION, Symbol::COMMENT, Symbol::DUPLEX, Symbol::MODE, Symbol::CHAIN,
+              Symbol::ACTION},
+             {{string}});
+        rule({Symbol::MTU, Symbol::SPEED, Symbol::VLAN_ID, Symbol::DISTANCE}, {{number, string}});
+        rule({Symbol::ADDRESS}, {{ip_cidr, ip_address, ipv6_cidr, ipv6_address, string}});
+        rule({Symbol::GATEWAY, Symbol::STATIC_ROUTE_DEFAULT_GW}, {{ip_address, ipv6_address, string}});
+        rule({Symbol::DESTINATION, Symbol::SRC_ADDRESS, Symbol::DST_ADDRESS, Symbol::SRC_ADDRESS_DASHED,
+              Symbol::DST_ADDRESS_DASHED},
+             {{ip_address, ip_cidr, ip_range, ipv6_address, ipv6_cidr, ipv6_range, string}});
+        rule({Symbol::SLAVES, Symbol::CONNECTION_STATE, Symbol::CONNECTION_STATE_DASHED},
+             {{string_list, string}});
+        return rules;
+    }();
+
+    if (symbol >= Symbol::FIRST_INTERNED) {
+        return nullptr;
+    }
+    const PropertyTypes& types = table[static_cast<size_t>(symbol)];
+    return types.accepted[0] ? &types : nullptr;
+}
+
+using Validation = std::tuple<bool, std::string>;
+
+// Catch-all of a validation visitor: the other node classes pass
+struct valid_node {
+    Validation operator()(const ASTNodeInterface&) const { return {true, ""}; }
+};
+
+// Visits the statements of block in order, as visit_statements() does, up
+// to the first that fails; none if block is null
+template <typename Visitor>
+Validation validate_statements(const BlockStatement* block, Visitor&& visitor) {
+    if (block) {
+        for (const Statement* stmt : block->get_statements()) {
+            Validation result = visit_node(*stmt, visitor);
+            if (!std::get<0>(result)) {
+                return result;
+            }
+        }
+    }
+    return {true, ""};
+}
+
+} // namespace
 
 // Base SectionValidator implementation
 SectionValidator::SectionValidator(std::string section_name, NestingRule nesting_rule)
@@ -10,30 +108,62 @@ std::string SectionValidator::getSectionName() const {
     return section_name_;
 }
 
+SourceSpan SectionValidator::getErrorSpan() const {
+    return error_span_;
+}
+
+std::tuple<bool, std::string> SectionValidator::failAt(const ASTNodeInterface* node, std::string message) const {
+    error_span_ = node->get_span();
+    return std::make_tuple(false, std::move(message));
+}
+
 std::tuple<bool, std::string> SectionValidator::validate(const BlockStatement* block) const {
     if (!block) {
         return std::make_tuple(false, section_name_ + " section is missing a block statement");
     }
     
+    error_span_ = block->get_span();
+
     // First validate the overall hierarchy
     auto hierarchy_result = validateHierarchy(block);
     if (!std::get<0>(hierarchy_result)) {
         return hierarchy_result;
     }
     
-    // Then validate individual properties for each subsection
-    for (const Statement* stmt : block->get_statements()) {
-        const SectionStatement* subsection = dynamic_cast<const SectionStatement*>(stmt);
-        
-        if (subsection) {
-            auto props_result = validateProperties(subsection);
-            if (!std::get<0>(props_result)) {
-                return props_result;
-            }
-        }
+    // Then the type of every property value
+    auto types_result = validateTypes(block);
+    if (!std::get<0>(types_result)) {
+        return types_result;
     }
     
-    return std::make_tuple(true, "");
+    // Then validate individual properties for each subsection
+    return validate_statements(block, overloaded{
+        [&](const SectionStatement& subsection) {
+            // Errors without a more precise node point at the subsection
+            error_span_ = subsection.get_span();
+            return validateProperties(&subsection);
+        },
+        valid_node{}});
+}
+
+std::tuple<bool, std::string> SectionValidator::validateTypes(const BlockStatement* block) const {
+    return validate_statements(block, overloaded{
+        [&](const PropertyStatement& prop) -> Validation {
+            const PropertyTypes* types = property_types(prop.get_symbol());
+            const Expression* value = prop.get_value();
+            if (types && value && !types->accepts(value->get_type())) {
+                return failAt(value, "Property '" + std::string(prop.get_name()) + "' expects " +
+                                     types->describe() + ", got " + value->get_type().type_name());
+            }
+            return {true, ""};
+        },
+        [&](const SectionStatement& subsection) {
+            return validateTypes(subsection.get_block());
+        },
+        [&](const BlockStatement& nested_block) {
+            return validateTypes(&nested_block);
+        },
+        valid_node{}});
 }
 
 std::tuple<bool, std::string> SectionValidator::validateHierarchy(const BlockStatement* block) const {
@@ -42,75 +172,49 @@ std::tuple<bool, std::string> SectionValidator::validateHierarchy(const BlockSta
         return std::make_tuple(true, "");
     }
     
-    // Keep track of top-level sections
-    std::set<std::string> top_level_sections;
-    
-    for (const Statement* stmt : block->get_statements()) {
-        const SectionStatement* subsection = dynamic_cast<const SectionStatement*>(stmt);
-        
-        if (subsection) {
-            const std::string& subsection_name = subsection->get_name();
-            top_level_sections.insert(subsection_name);
-            
-            // If nesting is completely disallowed, check there are no nested sections
-            if (nesting_rule_ == NestingRule::NO_NESTING) {
-                const BlockStatement* sub_block = subsection->get_block();
-                if (sub_block) {
-                    for (const Statement* nested_stmt : sub_block->get_statements()) {
-                        if (dynamic_cast<const SectionStatement*>(nested_stmt)) {
-                            return std::make_tuple(false, 
-                                "Semantic error: Section '" + subsection_name + 
-                                "' cannot contain nested sections in " + section_name_ + " section");
-                        }
-                    }
-                }
+    // Every section in the block, then the sections nested in it
+    return validate_statements(block, overloaded{
+        [&](const SectionStatement& section) {
+            auto result = validateNesting(section);
+            if (!std::get<0>(result)) {
+                return result;
             }
-            // For shallow nesting or conditional nesting, check each nested section
-            else if (nesting_rule_ == NestingRule::SHALLOW_NESTING || 
-                     nesting_rule_ == NestingRule::CONDITIONAL_NESTING) {
-                const BlockStatement* sub_block = subsection->get_block();
-                if (sub_block) {
-                    for (const Statement* nested_stmt : sub_block->get_statements()) {
-                        const SectionStatement* nested_section = 
-                            dynamic_cast<const SectionStatement*>(nested_stmt);
-                        
-                        if (nested_section) {
-                            const std::string& nested_name = nested_section->get_name();
-                            
-                            // For conditional nesting, check the condition
-                            if (nesting_rule_ == NestingRule::CONDITIONAL_NESTING && 
-                                !isValidNesting(subsection_name, nested_name)) {
-                                return std::make_tuple(false, 
-                                    "Semantic error: Section '" + nested_name + 
-                                    "' cannot be defined under '" + subsection_name + 
-                                    "' in " + section_name_ + " section");
-                            }
-                            
-                            // For shallow nesting, make sure there are no deeper nestings
-                            if (nesting_rule_ == NestingRule::SHALLOW_NESTING) {
-                                const BlockStatement* nested_block = nested_section->get_block();
-                                if (nested_block) {
-                                    for (const Statement* deep_stmt : nested_block->get_statements()) {
-                                        if (dynamic_cast<const SectionStatement*>(deep_stmt)) {
-                                            return std::make_tuple(false, 
-                                                "Semantic error: Nesting depth exceeded in " + 
-                                                section_name_ + " section (max 2 levels)");
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+            return validateHierarchy(section.get_block());
+        },
+        valid_node{}});
+}
+
+std::tuple<bool, std::string> SectionValidator::validateNesting(const SectionStatement& section) const {
+    // Sections of the validated block are at level 1, their own subsections
+    // at level 2 and so on: the depth link_subsections() cached
+    unsigned level = section.get_depth();
+    
+    // If nesting is completely disallowed, there are no nested sections
+    if (nesting_rule_ == NestingRule::NO_NESTING && level == 2) {
+        return failAt(&section, 
+            "Semantic error: Section '" + std::string(section.get_parent()->get_name()) + 
+            "' cannot contain nested sections in " + section_name_ + " section");
+    }
+    
+    // For conditional nesting, check the condition
+    if (nesting_rule_ == NestingRule::CONDITIONAL_NESTING && level == 2 && !isValidNesting(section)) {
+        return failAt(&section, 
+            "Semantic error: Section '" + std::string(section.get_name()) + 
+            "' cannot be defined under '" + std::string(section.get_parent()->get_name()) + 
+            "' in " + section_name_ + " section");
+    }
+    
+    // For shallow nesting, make sure there are no deeper nestings
+    if (nesting_rule_ == NestingRule::SHALLOW_NESTING && level == 3) {
+        return failAt(&section, 
+            "Semantic error: Nesting depth exceeded in " + 
+            section_name_ + " section (max 2 levels)");
     }
     
     return std::make_tuple(true, "");
 }
 
-bool SectionValidator::isValidNesting(const std::string& parent_name, 
-                                     const std::string& child_name) const {
+bool SectionValidator::isValidNesting(const SectionStatement& section) const {
     // Default implementation: no special nesting rules
     return true;
 }
@@ -120,45 +224,9 @@ DeviceValidator::DeviceValidator()
 
 std::tuple<bool, std::string> DeviceValidator::validateProperties(
     const SectionStatement* section) const {
-     bool has_vendor = false;
-    bool has_model = false;
-    bool has_hostname = false;
-        const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(section);
-        if (prop) {
-            const std::string& name = prop->get_name();
-            Expression* expr = prop->get_value();
-            
-            if (name == "vendor" && expr) {
-                const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                if (value) has_vendor = true;
-            }
-            else if (name == "model" && expr) {
-                const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                if (value) has_model = true;
-            }
-            else if (name == "hostname" && expr) {
-                const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                if (value) has_hostname = true;
-            }
-            else {
-                // Invalid property found - only hostname, vendor, and model are allowed
-                return {false, "Device section contains invalid property: " + name + 
-                              ". Only 'hostname', 'vendor', and 'model' are allowed"};
-            }
-        }
-        else {
-            // Non-property statement found in device section
-            return {false, "Device section contains an invalid statement type. Only property statements are allowed"};
-        }
-    
-    if (!has_vendor) 
-        return {false, "Device section is missing required 'vendor' property"};
-    if (!has_model) 
-        return {false, "Device section is missing required 'model' property"};
-    if (!has_hostname) 
-        return {false, "Device section is missing required 'hostname' property"};
-
-    return std::make_tuple(true, "");
+    // Only the subsections of the device block get here, and the device
+    // block may only hold its hostname, vendor and model properties
+    return failAt(section, "Device section contains an invalid statement type. Only property statements are allowed");
 }
 
 InterfacesValidator::InterfacesValidator()
@@ -190,43 +258,28 @@ std::tuple<bool, std::string> InterfacesValidator::validateProperties(
     const SectionStatement* section) const {
     
     bool has_type = false;
-    std::string interface_type = "";
+    std::string_view interface_type;
     const BlockStatement* block = section->get_block();
     
     if (!block) {
-        return std::make_tuple(false, "Interface section '" + section->get_name() + "' is missing a block statement");
+        return std::make_tuple(false, "Interface section '" + std::string(section->get_name()) + "' is missing a block statement");
     }
     
     // Check for required properties and validate all properties
-    for (const Statement* stmt : block->get_statements()) {
-        const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(stmt);
-        const SectionStatement* subsection = dynamic_cast<const SectionStatement*>(stmt);
-        
-        // Skip subsections as they are validated separately
-        if (subsection) continue;
-        
-        // Non-property, non-section statement found (invalid)
-        if (!prop && !subsection) {
-            return std::make_tuple(false, "Interface section contains an invalid statement type");
-        }
-        
-        // Process properties
-        if (prop) {
-            const std::string& name = prop->get_name();
-            Expression* expr = prop->get_value();
+    auto result = validate_statements(block, overloaded{
+        [&](const PropertyStatement& prop) -> Validation {
+            std::string_view name = prop.get_name();
+            Symbol symbol = prop.get_symbol();
+            Expression* expr = prop.get_value();
             
             // Check if this is a common valid property
             if (common_valid_props_.find(name) != common_valid_props_.end()) {
-                if (name == "type" && expr) {
+                if (symbol == Symbol::TYPE && expr) {
                     has_type = true;
                     
-                    const StringValue* type_value = dynamic_cast<const StringValue*>(expr);
+                    const StringValue* type_value = node_cast<StringValue>(expr);
                     if (type_value) {
                         interface_type = type_value->get_value();
-                        // Remove quotes if present
-                        if (interface_type.size() >= 2 && interface_type.front() == '"' && interface_type.back() == '"') {
-                            interface_type = interface_type.substr(1, interface_type.size() - 2);
-                        }
                     }
                 }
             }
@@ -249,63 +302,38 @@ std::tuple<bool, std::string> InterfacesValidator::validateProperties(
             }
             // Invalid property found
             else {
-                return std::make_tuple(false, "Interface section contains invalid property '" + name + 
+                return failAt(&prop, "Interface section contains invalid property '" + std::string(name) + 
                     "'. This property is not valid for interface configuration.");
             }
-        }
+            return {true, ""};
+        },
+        // Skip subsections as they are validated separately
+        [](const SectionStatement&) -> Validation { return {true, ""}; },
+        // Non-property, non-section statement found (invalid)
+        [&](const ASTNodeInterface& stmt) {
+            return failAt(&stmt, "Interface section contains an invalid statement type");
+        }});
+    if (!std::get<0>(result)) {
+        return result;
     }
     
     // For VLAN, check if parent interface and VLAN ID exist
     if (interface_type == "vlan") {
-        bool has_vlan_id = false;
-        bool has_parent = false;
-        
-        for (const Statement* stmt : block->get_statements()) {
-            const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(stmt);
-            if (prop) {
-                const std::string& name = prop->get_name();
-                Expression* expr = prop->get_value();
-                
-                if (name == "vlan_id" && expr) {
-                    has_vlan_id = true;
-                } else if (name == "interface" && expr) {
-                    has_parent = true;
-                }
-            }
-        }
-        
-        if (!has_vlan_id) return std::make_tuple(false, "VLAN interface is missing required 'vlan_id' property");
-        if (!has_parent) return std::make_tuple(false, "VLAN interface is missing required 'interface' property");
+        if (!block->find_property(Symbol::VLAN_ID)) return std::make_tuple(false, "VLAN interface is missing required 'vlan_id' property");
+        if (!block->find_property(Symbol::INTERFACE)) return std::make_tuple(false, "VLAN interface is missing required 'interface' property");
     }
     
     // For bonding, check if mode and slaves are set
     if (interface_type == "bonding") {
-        bool has_mode = false;
-        bool has_slaves = false;
-        
-        for (const Statement* stmt : block->get_statements()) {
-            const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(stmt);
-            if (prop) {
-                const std::string& name = prop->get_name();
-                Expression* expr = prop->get_value();
-                
-                if (name == "mode" && expr) {
-                    has_mode = true;
-                } else if (name == "slaves" && expr) {
-                    has_slaves = true;
-                }
-            }
-        }
-        
-        if (!has_mode) return std::make_tuple(false, "Bonding interface is missing required 'mode' property");
-        if (!has_slaves) return std::make_tuple(false, "Bonding interface is missing required 'slaves' property");
+        if (!block->find_property(Symbol::MODE)) return std::make_tuple(false, "Bonding interface is missing required 'mode' property");
+        if (!block->find_property(Symbol::SLAVES)) return std::make_tuple(false, "Bonding interface is missing required 'slaves' property");
     }
     
     return std::make_tuple(true, "");
 }
 
-bool InterfacesValidator::isValidNesting(const std::string& parent_name, 
-                                       const std::string& child_name) const {
+bool InterfacesValidator::isValidNesting(const SectionStatement& section) const {
+    std::string_view parent_name = section.get_parent()->get_name();
     // Most interface types should not have nested interfaces
     // Exceptions: configuration groups, profiles, templates
     
@@ -324,22 +352,14 @@ IPValidator::IPValidator()
 std::tuple<bool, std::string> IPValidator::validateProperties(
     const SectionStatement* section) const {
 
-    // Define regular expression for IPv4 validation
-    // Format: xxx.xxx.xxx.xxx/xx where xxx is 0-255 and xx is 0-32
-    std::regex ipv4_pattern("^((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])(\\/(3[0-2]|[1-2]?[0-9]))?$");
-    
     // Define valid subsections in IP section
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "address", "route", "firewall", "dhcp-server", "dhcp-client", 
         "dns", "arp", "service", "neighbor", "proxy"
     };
     
-    // Define valid properties directly under IP section
-    const std::set<std::string> valid_direct_props = {
-        "dns-server", "allow-remote-requests"
-    };
-    
-    std::string section_name = section->get_name();
+    std::string section_name(section->get_name());
+    Symbol section_symbol = section->get_symbol();
     
     // Check if this is an interface subsection (for address assignment)
     bool is_interface_section = true;
@@ -363,48 +383,43 @@ std::tuple<bool, std::string> IPValidator::validateProperties(
         bool has_address = false;
         
         // Check properties
-        for (const Statement* if_stmt : block->get_statements()) {
-            // Skip nested sections as they're validated by hierarchy validation
-            if (dynamic_cast<const SectionStatement*>(if_stmt)) {
-                continue;
-            }
-            
-            const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(if_stmt);
-            if (prop) {
-                const std::string& prop_name = prop->get_name();
+        auto result = validate_statements(block, overloaded{
+            [&](const PropertyStatement& prop) -> Validation {
+                std::string_view prop_name = prop.get_name();
+                Symbol prop_symbol = prop.get_symbol();
                 
                 // Validate address property
-                if (prop_name == "address") {
+                if (prop_symbol == Symbol::ADDRESS) {
                     has_address = true;
                     
                     // Check if the value is a valid IP address
-                    if (prop->get_value()) {
-                        const StringValue* addr_value = dynamic_cast<const StringValue*>(prop->get_value());
-                        if (addr_value) {
-                            std::string ip_addr = addr_value->get_value();
-                            // Remove quotes if present
-                            if (ip_addr.size() >= 2 && ip_addr.front() == '"' && ip_addr.back() == '"') {
-                                ip_addr = ip_addr.substr(1, ip_addr.size() - 2);
-                            }
-                            
-                            // Validate IP address format using regex
-                            if (!std::regex_match(ip_addr, ipv4_pattern)) {
-                                return {false, "Invalid IP address format in interface '" + section_name + 
-                                              "': " + ip_addr};
-                            }
+                    const StringValue* addr_value = node_cast<StringValue>(prop.get_value());
+                    if (addr_value) {
+                        std::string_view ip_addr = addr_value->get_value();
+                        
+                        // Validate IP address format: xxx.xxx.xxx.xxx with optional /xx
+                        // (unquoted IPAddressValue/IPCIDRValue literals were decoded by the scanner)
+                        IPv4Prefix decoded;
+                        if (!decode_ipv4_address_or_prefix(ip_addr, decoded)) {
+                            return failAt(&prop, "Invalid IP address format in interface '" + section_name + 
+                                          "': " + std::string(ip_addr));
                         }
                     }
-                } 
-                else {
-                    // Invalid property for interface IP section
-                    return {false, "Invalid property '" + prop_name + "' in IP interface section '" + 
-                                 section_name + "'. Only 'address' is allowed."};
+                    return {true, ""};
                 }
-            }
-            else {
-                // Unknown statement type that is not a property or section
-                return {false, "IP interface section contains an invalid statement type"};
-            }
+                
+                // Invalid property for interface IP section
+                return failAt(&prop, "Invalid property '" + std::string(prop_name) + "' in IP interface section '" + 
+                             section_name + "'. Only 'address' is allowed.");
+            },
+            // Skip nested sections as they're validated by hierarchy validation
+            [](const SectionStatement&) -> Validation { return {true, ""}; },
+            // Unknown statement type that is not a property or section
+            [&](const ASTNodeInterface& if_stmt) {
+                return failAt(&if_stmt, "IP interface section contains an invalid statement type");
+            }});
+        if (!std::get<0>(result)) {
+            return result;
         }
         
         // Ensure address is specified
@@ -414,92 +429,68 @@ std::tuple<bool, std::string> IPValidator::validateProperties(
         }
     }
     // Validate route subsection
-    else if (section_name == "route" || section_name == "routes") {
+    else if (section_symbol == Symbol::ROUTE || section_symbol == Symbol::ROUTES) {
         const BlockStatement* block = section->get_block();
         if (!block) {
             return {false, "IP route section is missing its block"};
         }
         
-        for (const Statement* route_stmt : block->get_statements()) {
-            const SectionStatement* route_section = dynamic_cast<const SectionStatement*>(route_stmt);
-            const PropertyStatement* route_prop = dynamic_cast<const PropertyStatement*>(route_stmt);
-            
-            // Default route is configured as a property
-            if (route_prop && route_prop->get_name() == "default") {
-                // Valid default route property
-                continue;
-            }
-            
-            // Specific route entries are sections
-            if (route_section) {
-                const BlockStatement* route_block = route_section->get_block();
+        // The default route is configured as a property, specific route
+        // entries are sections
+        return validate_statements(block, overloaded{
+            [&](const SectionStatement& route_section) -> Validation {
+                const BlockStatement* route_block = route_section.get_block();
                 if (!route_block) {
-                    return {false, "IP route entry '" + route_section->get_name() + "' is missing its block"};
+                    return failAt(&route_section, "IP route entry '" + std::string(route_section.get_name()) + "' is missing its block");
                 }
                 
                 bool has_gateway = false;
                 
-                for (const Statement* route_detail : route_block->get_statements()) {
-                    const PropertyStatement* detail_prop = dynamic_cast<const PropertyStatement*>(route_detail);
-                    if (detail_prop) {
-                        if (detail_prop->get_name() == "gateway") {
-                            has_gateway = true;
-                            
-                            // Validate gateway IP
-                            if (detail_prop->get_value()) {
-                                const StringValue* gw_value = dynamic_cast<const StringValue*>(detail_prop->get_value());
-                                if (gw_value) {
-                                    std::string gateway = gw_value->get_value();
-                                    // Remove quotes if present
-                                    if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                                        gateway = gateway.substr(1, gateway.size() - 2);
-                                    }
-                                    
-                                    // Validate gateway IP address format (without subnet)
-                                    std::regex ip_only("^((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])$");
-                                    if (!std::regex_match(gateway, ip_only)) {
-                                        return {false, "Invalid gateway IP address format in route '" + 
-                                                      route_section->get_name() + "': " + gateway};
-                                    }
-                                }
+                auto result = validate_statements(route_block, overloaded{
+                    [&](const PropertyStatement& detail_prop) -> Validation {
+                        if (detail_prop.get_symbol() != Symbol::GATEWAY) {
+                            return {true, ""};
+                        }
+                        has_gateway = true;
+                        
+                        // Validate gateway IP address format (without subnet)
+                        const StringValue* gw_value = node_cast<StringValue>(detail_prop.get_value());
+                        if (gw_value) {
+                            std::string_view gateway = gw_value->get_value();
+                            uint32_t decoded;
+                            if (!decode_ipv4(gateway, decoded)) {
+                                return failAt(&detail_prop, "Invalid gateway IP address format in route '" + 
+                                              std::string(route_section.get_name()) + "': " + std::string(gateway));
                             }
                         }
-                    }
+                        return {true, ""};
+                    },
+                    valid_node{}});
+                if (!std::get<0>(result)) {
+                    return result;
                 }
                 
                 // All routes should have a gateway
                 if (!has_gateway) {
-                    return {false, "IP route entry '" + route_section->get_name() + 
-                                  "' is missing required 'gateway' property"};
+                    return failAt(&route_section, "IP route entry '" + std::string(route_section.get_name()) + 
+                                  "' is missing required 'gateway' property");
                 }
-            }
-        }
+                return {true, ""};
+            },
+            valid_node{}});
     }
-    // For direct properties under the IP section
+    // A section without a block
     else if (!section->get_block()) { 
-        // This would be a direct property statement
-        const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(section);
-        if (prop) {
-            const std::string& prop_name = prop->get_name();
-            
-            // Check if it's a valid direct property
-            if (valid_direct_props.find(prop_name) == valid_direct_props.end()) {
-                return {false, "Invalid property '" + prop_name + "' directly under IP section"};
-            }
-        }
-        else {
-            // Unknown statement type
-            return {false, "IP section contains an invalid statement type"};
-        }
+        return failAt(section, "IP section contains an invalid statement type");
     }
     
     return {true, ""};
 }
 
-bool IPValidator::isValidNesting(const std::string& parent_name, 
-                              const std::string& child_name) const {
+bool IPValidator::isValidNesting(const SectionStatement& section) const {
+    std::string_view parent_name = section.get_parent()->get_name();
     // Define valid subsections
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "address", "route", "firewall", "dhcp-server", "dhcp-client", 
         "dns", "arp", "service", "neighbor", "proxy"
     };
@@ -532,17 +523,8 @@ RoutingValidator::RoutingValidator()
 std::tuple<bool, std::string> RoutingValidator::validateProperties(
     const SectionStatement* section) const {
     
-    // Define regular expression for IPv4 validation
-    std::regex ipv4_pattern("^((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])$");
-    std::regex cidr_pattern("^((25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])\\.){3}(25[0-5]|2[0-4][0-9]|1[0-9][0-9]|[1-9]?[0-9])(\\/(3[0-2]|[1-2]?[0-9]))$");
-    
-    // Define valid routing section properties
-    const std::set<std::string> valid_top_props = {
-        "static_route_default_gw" // Default gateway property
-    };
-    
     // Define valid properties for static routes
-    const std::set<std::string> valid_route_props = {
+    const std::set<std::string, std::less<>> valid_route_props = {
         "src_address", "src", "src-address", "src-address",
         "destination", "dst-address", "dst",       // Destination network
         "gateway", "gw",                          // Next hop
@@ -555,44 +537,12 @@ std::tuple<bool, std::string> RoutingValidator::validateProperties(
     };
     
     // Define valid routing subsections
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "table", "tables", "rule", "rules", "filter"
     };
     
-    std::string section_name = section->get_name();
-    
-    // First, check if this is a direct property entry (top-level)
-    const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(section);
-    if (prop) {
-        const std::string& name = prop->get_name();
-        
-        // Check if it's a valid top-level property
-        if (valid_top_props.find(name) == valid_top_props.end()) {
-            return {false, "Invalid property '" + name + "' in routing section. Top-level routing properties are limited."};
-        }
-        
-        // Validate default gateway
-        if (name == "static_route_default_gw") {
-            // Validate gateway IP address
-            if (prop->get_value()) {
-                const StringValue* gw_value = dynamic_cast<const StringValue*>(prop->get_value());
-                if (gw_value) {
-                    std::string gateway = gw_value->get_value();
-                    // Remove quotes if present
-                    if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                        gateway = gateway.substr(1, gateway.size() - 2);
-                    }
-                    
-                    // Validate gateway format using regex
-                    if (!std::regex_match(gateway, ipv4_pattern)) {
-                        return {false, "Invalid default gateway IP address format: " + gateway};
-                    }
-                }
-            }
-        }
-        
-        return {true, ""};
-    }
+    std::string section_name(section->get_name());
+    Symbol section_symbol = section->get_symbol();
     
     // Check for standard subsections
     bool is_standard_subsection = false;
@@ -604,7 +554,7 @@ std::tuple<bool, std::string> RoutingValidator::validateProperties(
     }
     
     // Table subsections validation
-    if (section_name == "table" || section_name == "tables") {
+    if (section_symbol == Symbol::TABLE || section_symbol == Symbol::TABLES) {
         const BlockStatement* block = section->get_block();
         if (!block) {
             return {false, "Routing table section is missing its block"};
@@ -616,7 +566,7 @@ std::tuple<bool, std::string> RoutingValidator::validateProperties(
     }
     
     // Rule subsections validation
-    if (section_name == "rule" || section_name == "rules") {
+    if (section_symbol == Symbol::RULE || section_symbol == Symbol::RULES) {
         const BlockStatement* block = section->get_block();
         if (!block) {
             return {false, "Routing rule section is missing its block"};
@@ -638,91 +588,62 @@ std::tuple<bool, std::string> RoutingValidator::validateProperties(
         bool has_gateway = false;
         
         // Validate route properties
-        for (const Statement* route_stmt : block->get_statements()) {
-            // Skip nested statements as they are validated by hierarchy validation
-            if (dynamic_cast<const SectionStatement*>(route_stmt)) {
-                continue;
-            }
-            
-            const PropertyStatement* route_prop = dynamic_cast<const PropertyStatement*>(route_stmt);
-            if (route_prop) {
-                const std::string& prop_name = route_prop->get_name();
+        auto result = validate_statements(block, overloaded{
+            [&](const PropertyStatement& route_prop) -> Validation {
+                std::string_view prop_name = route_prop.get_name();
+                Symbol prop_symbol = route_prop.get_symbol();
                 
                 // Check if this is a valid route property
                 if (valid_route_props.find(prop_name) == valid_route_props.end()) {
-                    return {false, "Invalid property '" + prop_name + "' in route '" + section_name + "'"};
+                    return failAt(&route_prop, "Invalid property '" + std::string(prop_name) + "' in route '" + section_name + "'");
                 }
                 
                 // Validate destination
-                if (prop_name == "destination" || prop_name == "dst-address" || prop_name == "dst") {
+                if (prop_symbol == Symbol::DESTINATION || prop_symbol == Symbol::DST_ADDRESS_DASHED || prop_symbol == Symbol::DST) {
                     has_destination = true;
                     
                     // Validate destination format
-                    if (route_prop->get_value()) {
-                        const StringValue* dst_value = dynamic_cast<const StringValue*>(route_prop->get_value());
-                        if (dst_value) {
-                            std::string destination = dst_value->get_value();
-                            // Remove quotes if present
-                            if (destination.size() >= 2 && destination.front() == '"' && destination.back() == '"') {
-                                destination = destination.substr(1, destination.size() - 2);
-                            }
-                            
-                            // Validate CIDR format
-                            if (!std::regex_match(destination, cidr_pattern)) {
-                                return {false, "Invalid destination network format in route '" + 
-                                              section_name + "': " + destination + 
-                                              ". Must be in CIDR format (e.g. 192.168.1.0/24)"};
-                            }
+                    const StringValue* dst_value = node_cast<StringValue>(route_prop.get_value());
+                    if (dst_value) {
+                        std::string_view destination = dst_value->get_value();
+                        
+                        // Validate CIDR format
+                        IPv4Prefix decoded;
+                        if (!decode_ipv4_prefix(destination, decoded)) {
+                            return failAt(&route_prop, "Invalid destination network format in route '" + 
+                                          section_name + "': " + std::string(destination) + 
+                                          ". Must be in CIDR format (e.g. 192.168.1.0/24)");
                         }
                     }
                 }
                 
-                // Validate gateway
-                if (prop_name == "gateway" || prop_name == "gw") {
+                // Validate gateway: interface names, IP addresses and
+                // routing marks are all accepted
+                if (prop_symbol == Symbol::GATEWAY || prop_symbol == Symbol::GW) {
                     has_gateway = true;
-                    
-                    // Validate gateway format
-                    if (route_prop->get_value()) {
-                        const StringValue* gw_value = dynamic_cast<const StringValue*>(route_prop->get_value());
-                        if (gw_value) {
-                            std::string gateway = gw_value->get_value();
-                            // Remove quotes if present
-                            if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                                gateway = gateway.substr(1, gateway.size() - 2);
-                            }
-                            
-                            // Allow interface names, IP addresses, or routing marks
-                            if (!std::regex_match(gateway, ipv4_pattern) && 
-                                gateway.find("ether") != 0 && 
-                                gateway.find("wlan") != 0 &&
-                                gateway.find("bridge") != 0) {
-                                
-                                // If not an IP or common interface, warn but don't fail
-                                // (could be a custom interface name or routing mark)
-                                // Consider adding more validation here if needed
-                            }
-                        }
-                    }
                 }
                 
                 // Validate distance
-                if (prop_name == "distance") {
-                    if (route_prop->get_value()) {
-                        const NumberValue* distance_value = dynamic_cast<const NumberValue*>(route_prop->get_value());
-                        if (!distance_value) {
-                            return {false, "Distance property in route '" + section_name + 
-                                          "' must be a number"};
-                        }
-                        
-                        // Check distance range (1-255)
-                        double distance = distance_value->get_value();
-                        if (distance < 1 || distance > 255) {
-                            return {false, "Distance value in route '" + section_name + 
-                                          "' must be between 1 and 255"};
-                        }
+                if (prop_symbol == Symbol::DISTANCE && route_prop.get_value()) {
+                    const NumberValue* distance_value = node_cast<NumberValue>(route_prop.get_value());
+                    if (!distance_value) {
+                        return failAt(&route_prop, "Distance property in route '" + section_name + 
+                                      "' must be a number");
+                    }
+                    
+                    // Check distance range (1-255)
+                    double distance = distance_value->get_value();
+                    if (distance < 1 || distance > 255) {
+                        return failAt(&route_prop, "Distance value in route '" + section_name + 
+                                      "' must be between 1 and 255");
                     }
                 }
-            }
+                return {true, ""};
+            },
+            // Skip nested statements as they are validated by hierarchy validation
+            valid_node{}});
+        if (!std::get<0>(result)) {
+            return result;
         }
         
         // All static routes should have both destination and gateway
@@ -738,10 +659,10 @@ std::tuple<bool, std::string> RoutingValidator::validateProperties(
     return {true, ""};
 }
 
-bool RoutingValidator::isValidNesting(const std::string& parent_name, 
-                                    const std::string& child_name) const {
+bool RoutingValidator::isValidNesting(const SectionStatement& section) const {
+    std::string_view parent_name = section.get_parent()->get_name();
     // Define valid routing subsections
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "table", "tables", "rule", "rules", "filter"
     };
     
@@ -776,33 +697,33 @@ std::tuple<bool, std::string> FirewallValidator::validateProperties(
     const SectionStatement* section) const {
     
     // Define valid subsections in a firewall configuration
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "filter", "nat", "mangle", "raw", "address-list", "service-port", "layer7-protocol"
     };
     
     // Define valid filter chains
-    const std::set<std::string> valid_filter_chains = {
+    const std::set<std::string, std::less<>> valid_filter_chains = {
         "input", "forward", "output"
     };
     
     // Define valid NAT chains
-    const std::set<std::string> valid_nat_chains = {
+    const std::set<std::string, std::less<>> valid_nat_chains = {
         "srcnat", "dstnat", "prerouting", "postrouting"
     };
     
     // Define valid actions for filter rules
-    const std::set<std::string> valid_filter_actions = {
+    const std::set<std::string, std::less<>> valid_filter_actions = {
         "accept", "drop", "reject", "log", "tarpit", "jump", "fasttrack-connection",
         "add-src-to-address-list", "add-dst-to-address-list"
     };
     
     // Define valid actions for NAT rules
-    const std::set<std::string> valid_nat_actions = {
+    const std::set<std::string, std::less<>> valid_nat_actions = {
         "accept", "drop", "masquerade", "redirect", "dst-nat", "src-nat", "same", "netmap"
     };
     
     // Define valid common properties for all rule types
-    const std::set<std::string> common_rule_props = {
+    const std::set<std::string, std::less<>> common_rule_props = {
         "chain", "action", "protocol", "src-address", "dst-address", 
         "src-port", "dst-port", "in-interface", "out-interface", 
         "src_address", "dst_address", "src_port", "dst_port", 
@@ -810,260 +731,209 @@ std::tuple<bool, std::string> FirewallValidator::validateProperties(
     };
     
     // Define connection-state related properties
-    const std::set<std::string> connection_state_props = {
+    const std::set<std::string, std::less<>> connection_state_props = {
         "connection-state", "connection_state"
     };
     
     // Define valid connection states
-    const std::set<std::string> valid_connection_states = {
+    const std::set<std::string, std::less<>> valid_connection_states = {
         "established", "related", "new", "invalid"
     };
     
     // Define NAT specific properties
-    const std::set<std::string> nat_specific_props = {
+    const std::set<std::string, std::less<>> nat_specific_props = {
         "to-addresses", "to-ports", "to_addresses", "to_ports"
     };
     
     // If this is a top-level firewall section, validate its subsections
     if (section->get_block()) {
         // We're simply checking if the name is one of the valid top-level firewall sections
-        std::string section_name = section->get_name();
+        Symbol section_symbol = section->get_symbol();
         
         // Not a top-level section? Check if it's a filter rule or NAT rule
-        if (section_name == "filter") {
+        if (section_symbol == Symbol::FILTER) {
             // Validate filter rule
-            const BlockStatement* block = section->get_block();
-            if (!block) {
-                return {false, "Filter section is missing its block"};
-            }
-            
-            for (const auto* rule_stmt : block->get_statements()) {
-                const SectionStatement* rule = dynamic_cast<const SectionStatement*>(rule_stmt);
-                if (!rule) {
-                    return {false, "Filter section can only contain rule subsections"};
-                }
-                
-                const BlockStatement* rule_block = rule->get_block();
-                if (!rule_block) {
-                    return {false, "Filter rule '" + rule->get_name() + "' is missing its block"};
-                }
-                
-                bool has_chain = false;
-                bool has_action = false;
-                std::string chain_value;
-                std::string action_value;
-                
-                // Validate rule properties
-                for (const auto* prop_stmt : rule_block->get_statements()) {
-                    const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(prop_stmt);
-                    if (!prop) {
-                        continue;
+            return validate_statements(section->get_block(), overloaded{
+                [&](const SectionStatement& rule) -> Validation {
+                    const BlockStatement* rule_block = rule.get_block();
+                    if (!rule_block) {
+                        return failAt(&rule, "Filter rule '" + std::string(rule.get_name()) + "' is missing its block");
                     }
                     
-                    std::string prop_name = prop->get_name();
+                    bool has_chain = false;
+                    bool has_action = false;
                     
-                    // Check if property is valid for filter rule
-                    if (common_rule_props.find(prop_name) == common_rule_props.end() && 
-                        connection_state_props.find(prop_name) == connection_state_props.end()) {
-                        return {false, "Invalid property '" + prop_name + "' in filter rule '" + 
-                                     rule->get_name() + "'"};
-                    }
-                    
-                    // Validate chain
-                    if (prop_name == "chain") {
-                        has_chain = true;
-                        if (prop->get_value()) {
-                            const StringValue* chain_str = dynamic_cast<const StringValue*>(prop->get_value());
-                            if (chain_str) {
-                                chain_value = chain_str->get_value();
-                                // Remove quotes if present
-                                if (chain_value.size() >= 2 && chain_value.front() == '"' && chain_value.back() == '"') {
-                                    chain_value = chain_value.substr(1, chain_value.size() - 2);
-                                }
-                                
-                                if (valid_filter_chains.find(chain_value) == valid_filter_chains.end()) {
-                                    return {false, "Invalid filter chain '" + chain_value + 
-                                                 "'. Valid chains are: input, forward, output"};
-                                }
+                    // Validate rule properties
+                    auto result = validate_statements(rule_block, overloaded{
+                        [&](const PropertyStatement& prop) -> Validation {
+                            std::string_view prop_name = prop.get_name();
+                            Symbol prop_symbol = prop.get_symbol();
+                            
+                            // Check if property is valid for filter rule
+                            if (common_rule_props.find(prop_name) == common_rule_props.end() && 
+                                connection_state_props.find(prop_name) == connection_state_props.end()) {
+                                return failAt(&prop, "Invalid property '" + std::string(prop_name) + "' in filter rule '" + 
+                                             std::string(rule.get_name()) + "'");
                             }
-                        }
-                    }
-                    
-                    // Validate action
-                    if (prop_name == "action") {
-                        has_action = true;
-                        if (prop->get_value()) {
-                            const StringValue* action_str = dynamic_cast<const StringValue*>(prop->get_value());
-                            if (action_str) {
-                                action_value = action_str->get_value();
-                                // Remove quotes if present
-                                if (action_value.size() >= 2 && action_value.front() == '"' && action_value.back() == '"') {
-                                    action_value = action_value.substr(1, action_value.size() - 2);
-                                }
-                                
-                                if (valid_filter_actions.find(action_value) == valid_filter_actions.end()) {
-                                    return {false, "Invalid filter action '" + action_value + 
-                                                 "'. Valid actions are: accept, drop, reject, etc."};
+                            
+                            // Validate chain
+                            if (prop_symbol == Symbol::CHAIN) {
+                                has_chain = true;
+                                const StringValue* chain_str = node_cast<StringValue>(prop.get_value());
+                                if (chain_str) {
+                                    std::string_view chain_value = chain_str->get_value();
+                                    
+                                    if (valid_filter_chains.find(chain_value) == valid_filter_chains.end()) {
+                                        return failAt(&prop, "Invalid filter chain '" + std::string(chain_value) + 
+                                                     "'. Valid chains are: input, forward, output");
+                                    }
                                 }
                             }
-                        }
-                    }
-                    
-                    // Validate connection-state if present
-                    if (prop_name == "connection_state" || prop_name == "connection-state") {
-                        if (prop->get_value()) {
-                            // Could be a string or a list
-                            const StringValue* state_str = dynamic_cast<const StringValue*>(prop->get_value());
-                            const ListValue* state_list = dynamic_cast<const ListValue*>(prop->get_value());
                             
-                            if (state_str) {
-                                std::string state = state_str->get_value();
-                                // Remove quotes if present
-                                if (state.size() >= 2 && state.front() == '"' && state.back() == '"') {
-                                    state = state.substr(1, state.size() - 2);
-                                }
-                                
-                                if (valid_connection_states.find(state) == valid_connection_states.end()) {
-                                    return {false, "Invalid connection state '" + state + 
-                                                 "'. Valid states are: established, related, new, invalid"};
+                            // Validate action
+                            if (prop_symbol == Symbol::ACTION) {
+                                has_action = true;
+                                const StringValue* action_str = node_cast<StringValue>(prop.get_value());
+                                if (action_str) {
+                                    std::string_view action_value = action_str->get_value();
+                                    
+                                    if (valid_filter_actions.find(action_value) == valid_filter_actions.end()) {
+                                        return failAt(&prop, "Invalid filter action '" + std::string(action_value) + 
+                                                     "'. Valid actions are: accept, drop, reject, etc.");
+                                    }
                                 }
-                            } else if (state_list) {
-                                // Validate each state in the list
-                                for (const auto* state_value : state_list->get_values()) {
-                                    const StringValue* state_str = dynamic_cast<const StringValue*>(state_value);
-                                    if (state_str) {
-                                        std::string state = state_str->get_value();
-                                        // Remove quotes if present
-                                        if (state.size() >= 2 && state.front() == '"' && state.back() == '"') {
-                                            state = state.substr(1, state.size() - 2);
-                                        }
+                            }
+                            
+                            // Validate connection-state if present, a string or a list
+                            if ((prop_symbol == Symbol::CONNECTION_STATE || prop_symbol == Symbol::CONNECTION_STATE_DASHED) &&
+                                prop.get_value()) {
+                                return visit_node(*prop.get_value(), overloaded{
+                                    [&](const StringValue& state_str) -> Validation {
+                                        std::string_view state = state_str.get_value();
                                         
                                         if (valid_connection_states.find(state) == valid_connection_states.end()) {
-                                            return {false, "Invalid connection state '" + state + 
-                                                         "' in list. Valid states are: established, related, new, invalid"};
+                                            return failAt(&prop, "Invalid connection state '" + std::string(state) + 
+                                                         "'. Valid states are: established, related, new, invalid");
                                         }
-                                    }
-                                }
+                                        return {true, ""};
+                                    },
+                                    [&](const ListValue& state_list) -> Validation {
+                                        // Validate each state in the list
+                                        for (const auto* state_value : state_list.get_values()) {
+                                            const StringValue* state_str = node_cast<StringValue>(state_value);
+                                            if (state_str) {
+                                                std::string_view state = state_str->get_value();
+                                                
+                                                if (valid_connection_states.find(state) == valid_connection_states.end()) {
+                                                    return failAt(state_value, "Invalid connection state '" + std::string(state) + 
+                                                                 "' in list. Valid states are: established, related, new, invalid");
+                                                }
+                                            }
+                                        }
+                                        return {true, ""};
+                                    },
+                                    valid_node{}});
                             }
-                        }
+                            return {true, ""};
+                        },
+                        valid_node{}});
+                    if (!std::get<0>(result)) {
+                        return result;
                     }
-                }
-                
-                // Ensure required properties are present
-                if (!has_chain) {
-                    return {false, "Filter rule '" + rule->get_name() + "' is missing required 'chain' property"};
-                }
-                
-                if (!has_action) {
-                    return {false, "Filter rule '" + rule->get_name() + "' is missing required 'action' property"};
-                }
-            }
+                    
+                    // Ensure required properties are present
+                    if (!has_chain) {
+                        return failAt(&rule, "Filter rule '" + std::string(rule.get_name()) + "' is missing required 'chain' property");
+                    }
+                    
+                    if (!has_action) {
+                        return failAt(&rule, "Filter rule '" + std::string(rule.get_name()) + "' is missing required 'action' property");
+                    }
+                    return {true, ""};
+                },
+                [&](const ASTNodeInterface& rule_stmt) {
+                    return failAt(&rule_stmt, "Filter section can only contain rule subsections");
+                }});
         }
         // Validate NAT rules
-        else if (section_name == "nat") {
-            const BlockStatement* block = section->get_block();
-            if (!block) {
-                return {false, "NAT section is missing its block"};
-            }
-            
-            for (const auto* rule_stmt : block->get_statements()) {
-                const SectionStatement* rule = dynamic_cast<const SectionStatement*>(rule_stmt);
-                if (!rule) {
-                    return {false, "NAT section can only contain rule subsections"};
-                }
-                
-                const BlockStatement* rule_block = rule->get_block();
-                if (!rule_block) {
-                    return {false, "NAT rule '" + rule->get_name() + "' is missing its block"};
-                }
-                
-                bool has_chain = false;
-                bool has_action = false;
-                std::string chain_value;
-                std::string action_value;
-                
-                // Validate rule properties
-                for (const auto* prop_stmt : rule_block->get_statements()) {
-                    const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(prop_stmt);
-                    if (!prop) {
-                        continue;
+        else if (section_symbol == Symbol::NAT) {
+            return validate_statements(section->get_block(), overloaded{
+                [&](const SectionStatement& rule) -> Validation {
+                    const BlockStatement* rule_block = rule.get_block();
+                    if (!rule_block) {
+                        return failAt(&rule, "NAT rule '" + std::string(rule.get_name()) + "' is missing its block");
                     }
                     
-                    std::string prop_name = prop->get_name();
+                    bool has_chain = false;
+                    bool has_action = false;
+                    std::string_view action_value;
                     
-                    // Check if property is valid for NAT rule
-                    if (common_rule_props.find(prop_name) == common_rule_props.end() && 
-                        nat_specific_props.find(prop_name) == nat_specific_props.end()) {
-                        return {false, "Invalid property '" + prop_name + "' in NAT rule '" + 
-                                     rule->get_name() + "'"};
-                    }
-                    
-                    // Validate chain
-                    if (prop_name == "chain") {
-                        has_chain = true;
-                        if (prop->get_value()) {
-                            const StringValue* chain_str = dynamic_cast<const StringValue*>(prop->get_value());
-                            if (chain_str) {
-                                chain_value = chain_str->get_value();
-                                // Remove quotes if present
-                                if (chain_value.size() >= 2 && chain_value.front() == '"' && chain_value.back() == '"') {
-                                    chain_value = chain_value.substr(1, chain_value.size() - 2);
+                    // Validate rule properties
+                    auto result = validate_statements(rule_block, overloaded{
+                        [&](const PropertyStatement& prop) -> Validation {
+                            std::string_view prop_name = prop.get_name();
+                            Symbol prop_symbol = prop.get_symbol();
+                            
+                            // Check if property is valid for NAT rule
+                            if (common_rule_props.find(prop_name) == common_rule_props.end() && 
+                                nat_specific_props.find(prop_name) == nat_specific_props.end()) {
+                                return failAt(&prop, "Invalid property '" + std::string(prop_name) + "' in NAT rule '" + 
+                                             std::string(rule.get_name()) + "'");
+                            }
+                            
+                            // Validate chain
+                            if (prop_symbol == Symbol::CHAIN) {
+                                has_chain = true;
+                                const StringValue* chain_str = node_cast<StringValue>(prop.get_value());
+                                if (chain_str) {
+                                    std::string_view chain_value = chain_str->get_value();
+                                    
+                                    if (valid_nat_chains.find(chain_value) == valid_nat_chains.end()) {
+                                        return failAt(&prop, "Invalid NAT chain '" + std::string(chain_value) + 
+                                                     "'. Valid chains are: srcnat, dstnat, prerouting, postrouting");
+                                    }
                                 }
-                                
-                                if (valid_nat_chains.find(chain_value) == valid_nat_chains.end()) {
-                                    return {false, "Invalid NAT chain '" + chain_value + 
-                                                 "'. Valid chains are: srcnat, dstnat, prerouting, postrouting"};
+                            }
+                            
+                            // Validate action
+                            if (prop_symbol == Symbol::ACTION) {
+                                has_action = true;
+                                const StringValue* action_str = node_cast<StringValue>(prop.get_value());
+                                if (action_str) {
+                                    action_value = action_str->get_value();
+                                    
+                                    if (valid_nat_actions.find(action_value) == valid_nat_actions.end()) {
+                                        return failAt(&prop, "Invalid NAT action '" + std::string(action_value) + 
+                                                     "'. Valid actions are: masquerade, dst-nat, src-nat, etc.");
+                                    }
                                 }
                             }
-                        }
+                            return {true, ""};
+                        },
+                        valid_node{}});
+                    if (!std::get<0>(result)) {
+                        return result;
                     }
                     
-                    // Validate action
-                    if (prop_name == "action") {
-                        has_action = true;
-                        if (prop->get_value()) {
-                            const StringValue* action_str = dynamic_cast<const StringValue*>(prop->get_value());
-                            if (action_str) {
-                                action_value = action_str->get_value();
-                                // Remove quotes if present
-                                if (action_value.size() >= 2 && action_value.front() == '"' && action_value.back() == '"') {
-                                    action_value = action_value.substr(1, action_value.size() - 2);
-                                }
-                                
-                                if (valid_nat_actions.find(action_value) == valid_nat_actions.end()) {
-                                    return {false, "Invalid NAT action '" + action_value + 
-                                                 "'. Valid actions are: masquerade, dst-nat, src-nat, etc."};
-                                }
-                            }
-                        }
+                    // Ensure required properties are present
+                    if (!has_chain) {
+                        return failAt(&rule, "NAT rule '" + std::string(rule.get_name()) + "' is missing required 'chain' property");
                     }
-                }
-                
-                // Ensure required properties are present
-                if (!has_chain) {
-                    return {false, "NAT rule '" + rule->get_name() + "' is missing required 'chain' property"};
-                }
-                
-                if (!has_action) {
-                    return {false, "NAT rule '" + rule->get_name() + "' is missing required 'action' property"};
-                }
-                
-                // Check specific requirements for certain NAT actions
-                if (action_value == "masquerade") {
-                    bool has_out_interface = false;
-                    for (const auto* prop_stmt : rule_block->get_statements()) {
-                        const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(prop_stmt);
-                        if (prop && (prop->get_name() == "out_interface" || prop->get_name() == "out-interface")) {
-                            has_out_interface = true;
-                            break;
-                        }
+                    
+                    if (!has_action) {
+                        return failAt(&rule, "NAT rule '" + std::string(rule.get_name()) + "' is missing required 'action' property");
                     }
                     
-                    if (!has_out_interface) {
-                        return {false, "NAT rule with 'masquerade' action requires 'out_interface' property"};
+                    // Check specific requirements for certain NAT actions
+                    if (action_value == "masquerade" &&
+                        !rule_block->find_property(Symbol::OUT_INTERFACE, Symbol::OUT_INTERFACE_DASHED)) {
+                        return failAt(&rule, "NAT rule with 'masquerade' action requires 'out_interface' property");
                     }
-                }
-            }
+                    return {true, ""};
+                },
+                [&](const ASTNodeInterface& rule_stmt) {
+                    return failAt(&rule_stmt, "NAT section can only contain rule subsections");
+                }});
         }
         // Validation for other subsections can be added here
     }
@@ -1071,10 +941,10 @@ std::tuple<bool, std::string> FirewallValidator::validateProperties(
     return {true, ""};
 }
 
-bool FirewallValidator::isValidNesting(const std::string& parent_name, 
-                                     const std::string& child_name) const {
+bool FirewallValidator::isValidNesting(const SectionStatement& section) const {
+    std::string_view parent_name = section.get_parent()->get_name();
     // Define valid firewall subsections
-    const std::set<std::string> valid_subsections = {
+    const std::set<std::string, std::less<>> valid_subsections = {
         "filter", "nat", "mangle", "raw", "address-list", "service-port", "layer7-protocol"
     };
     
@@ -33,6 +33,13 @@ public:
      */
     std::tuple<bool, std::string> validate(const BlockStatement* block) const;
 
+    /**
+     * @brief Get the location of the last validation error
+     * @return Span of the offending statement or value, or of the subsection
+     *         (block) being validated when no single node is to blame
+     */
+    SourceSpan getErrorSpan() const;
+
 protected:
     // Types of section nesting allowed
     enum class NestingRule {
@@ -63,30 +70,54 @@ protected:
         const SectionStatement* section) const = 0;
     
     /**
-     * @brief Check if nesting is valid for the given parent and child
-     * @param parent_name The name of the parent section
-     * @param child_name The name of the child section
+     * @brief Check if a section may be nested in its parent
+     * @param section A subsection of a subsection, linked to its parent
      * @return True if nesting is allowed, false otherwise
      */
-    virtual bool isValidNesting(const std::string& parent_name, 
-                               const std::string& child_name) const;
+    virtual bool isValidNesting(const SectionStatement& section) const;
                                
     /**
      * @brief Get the name of this section type
      * @return Section name
      */
     std::string getSectionName() const;
+
+    /**
+     * @brief Build a failed validation result located at a node
+     * @param node The statement or value the error is about
+     * @param message Error message
+     * @return Tuple of false and the error message
+     */
+    std::tuple<bool, std::string> failAt(const ASTNodeInterface* node, std::string message) const;
     
 private:
     std::string section_name_;
     NestingRule nesting_rule_;
+    mutable SourceSpan error_span_{0, 0};
     
     /**
-     * @brief Validate the hierarchical structure of the section
+     * @brief Validate the hierarchical structure of the section, every
+     *        section nested in it at any depth
      * @param block The block statement containing the section content
      * @return Tuple of validation result and error message
      */
     std::tuple<bool, std::string> validateHierarchy(const BlockStatement* block) const;
+
+    /**
+     * @brief Check one section against the nesting rule, by its level under
+     *        the validated section (its cached depth)
+     * @param section A section nested in the validated section
+     * @return Tuple of validation result and error message
+     */
+    std::tuple<bool, std::string> validateNesting(const SectionStatement& section) const;
+
+    /**
+     * @brief Check the value type of every property in the section, at any
+     *        depth, against the types its name accepts
+     * @param block The block statement containing the section content
+     * @return Tuple of validation result and error message
+     */
+    std::tuple<bool, std::string> validateTypes(const BlockStatement* block) const;
 };
 
 class DeviceValidator : public SectionValidator {
@@ -109,16 +140,15 @@ protected:
     std::tuple<bool, std::string> validateProperties(
         const SectionStatement* section) const override;
         
-    bool isValidNesting(const std::string& parent_name, 
-                       const std::string& child_name) const override;
+    bool isValidNesting(const SectionStatement& section) const override;
                        
 private:
     // Define valid properties for different interface types
-    std::set<std::string> common_valid_props_;
-    std::set<std::string> vlan_specific_props_;
-    std::set<std::string> bonding_specific_props_;
-    std::set<std::string> bridge_specific_props_;
-    std::set<std::string> ethernet_specific_props_;
+    std::set<std::string, std::less<>> common_valid_props_;
+    std::set<std::string, std::less<>> vlan_specific_props_;
+    std::set<std::string, std::less<>> bonding_specific_props_;
+    std::set<std::string, std::less<>> bridge_specific_props_;
+    std::set<std::string, std::less<>> ethernet_specific_props_;
 };
 
 /**
@@ -133,8 +163,7 @@ protected:
     std::tuple<bool, std::string> validateProperties(
         const SectionStatement* section) const override;
     
-    bool isValidNesting(const std::string& parent_name, 
-                       const std::string& child_name) const override;
+    bool isValidNesting(const SectionStatement& section) const override;
 };
 
 /**
@@ -149,8 +178,7 @@ protected:
     std::tuple<bool, std::string> validateProperties(
         const SectionStatement* section) const override;
         
-    bool isValidNesting(const std::string& parent_name, 
-                       const std::string& child_name) const override;
+    bool isValidNesting(const SectionStatement& section) const override;
 };
 
 /**
@@ -165,8 +193,7 @@ protected:
     std::tuple<bool, std::string> validateProperties(
         const SectionStatement* section) const override;
         
-    bool isValidNesting(const std::string& parent_name, 
-                       const std::string& child_name) const override;
+    bool isValidNesting(const SectionStatement& section) const override;
 };
 
 /**
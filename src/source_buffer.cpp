@@ -0,0 +1,97 @@
+#include "source_buffer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceBuffer::~SourceBuffer()
+{
+    close();
+}
+
+bool SourceBuffer::open(const std::string& path) noexcept
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Only regular files can be mapped, pipes and devices report no size
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    // Room for the contents plus the two NULs flex needs, rounded to pages
+    size_t total = ((file_size + 2 + page_size - 1) / page_size) * page_size;
+
+    // Reserve the whole range as zero-filled anonymous memory first, then
+    // place the file on top of it. Whatever follows the file contents in the
+    // last page (or in the extra page) is therefore guaranteed to be zero.
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    if (file_size > 0) {
+        // MAP_PRIVATE: flex temporarily writes NULs after each token, those
+        // writes must never reach the file.
+        void* file_map = mmap(base, file_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file_map == MAP_FAILED) {
+            munmap(base, total);
+            ::close(fd);
+            return false;
+        }
+        madvise(base, file_size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+
+    data = static_cast<char*>(base);
+    size = file_size;
+    mapped_size = total;
+    return true;
+}
+
+void SourceBuffer::close() noexcept
+{
+    if (data != nullptr) {
+        munmap(data, mapped_size);
+    }
+    data = nullptr;
+    size = 0;
+    mapped_size = 0;
+}
+
+bool SourceBuffer::is_open() const noexcept
+{
+    return data != nullptr;
+}
+
+char* SourceBuffer::get_data() const noexcept
+{
+    return data;
+}
+
+size_t SourceBuffer::get_size() const noexcept
+{
+    return size;
+}
+
+size_t SourceBuffer::get_scan_size() const noexcept
+{
+    return size + 2;
+}
+
+bool SourceBuffer::contains(const char* text, size_t length) const noexcept
+{
+    return data != nullptr && text >= data && text + length <= data + size;
+}
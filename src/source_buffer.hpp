@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole DSL source file.
+// The file is memory-mapped privately (copy-on-write) and followed by the
+// two NUL bytes flex expects at the end of a buffer given to yy_scan_buffer,
+// so the scanner works directly on the mapping without copying the input.
+class SourceBuffer
+{
+public:
+    SourceBuffer() noexcept = default;
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    // Maps the regular file at path. Returns false if it cannot be mapped.
+    bool open(const std::string& path) noexcept;
+    void close() noexcept;
+
+    bool is_open() const noexcept;
+
+    // Start of the scan buffer (file contents followed by two NULs)
+    char* get_data() const noexcept;
+    // Size of the file contents, without the NUL terminators
+    size_t get_size() const noexcept;
+    // Size to hand to yy_scan_buffer (contents plus the NUL terminators)
+    size_t get_scan_size() const noexcept;
+
+    // True if [text, text + length) lies inside the mapped contents
+    bool contains(const char* text, size_t length) const noexcept;
+
+private:
+    char* data = nullptr;
+    size_t size = 0;
+    size_t mapped_size = 0;
+};
@@ -0,0 +1,29 @@
+#include "source_span.hpp"
+
+#include <algorithm>
+
+LineIndex::LineIndex() : line_starts{0} {}
+
+void LineIndex::add_line(uint32_t offset)
+{
+    if (offset > line_starts.back()) {
+        line_starts.push_back(offset);
+    }
+}
+
+SourcePosition LineIndex::position(uint32_t offset) const noexcept
+{
+    // Last line starting at or before offset
+    auto line = std::upper_bound(line_starts.begin(), line_starts.end(), offset) - 1;
+    return SourcePosition{static_cast<uint32_t>(line - line_starts.begin()) + 1, offset - *line + 1};
+}
+
+size_t LineIndex::get_line_count() const noexcept
+{
+    return line_starts.size();
+}
+
+const std::vector<uint32_t>& LineIndex::get_line_starts() const noexcept
+{
+    return line_starts;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Location of a token or AST node: a byte range of the input. Line and
+// column are not stored, they are looked up in the LineIndex when a
+// diagnostic needs them. Trivially copyable so bison can use it as YYLTYPE
+// and grow its stacks (see YYLTYPE_IS_TRIVIAL in parser.bison).
+struct SourceSpan
+{
+    uint32_t offset;
+    uint32_t length;
+
+    SourceSpan() = default;
+    constexpr SourceSpan(uint32_t offset, uint32_t length) noexcept : offset(offset), length(length) {}
+    // With YYLTYPE_IS_TRIVIAL, bison initializes its default location with
+    // {1, 1, 1, 1}, the lines and columns of its own location type
+    constexpr SourceSpan(int, int, int, int) noexcept : offset(0), length(0) {}
+
+    uint32_t end() const noexcept { return offset + length; }
+};
+
+// Smallest span covering both
+inline SourceSpan merge_spans(SourceSpan first, SourceSpan last) noexcept
+{
+    return SourceSpan{first.offset, last.end() - first.offset};
+}
+
+// 1-based line and column (in bytes) of an offset
+struct SourcePosition
+{
+    uint32_t line;
+    uint32_t column;
+};
+
+// Start offsets of the input lines, recorded by the lexer while scanning so
+// positions never require going back to the input (which may be a pipe).
+class LineIndex
+{
+public:
+    LineIndex();
+
+    // Records that a line starts at offset. Offsets must be increasing;
+    // a line already recorded is ignored.
+    void add_line(uint32_t offset);
+
+    // Line and column of offset, O(log lines)
+    SourcePosition position(uint32_t offset) const noexcept;
+
+    size_t get_line_count() const noexcept;
+    // Start offsets in order, the first line starts at 0
+    const std::vector<uint32_t>& get_line_starts() const noexcept;
+
+private:
+    std::vector<uint32_t> line_starts;
+};
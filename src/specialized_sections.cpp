@@ -1,13 +1,32 @@
 #include "specialized_sections.hpp"
 #include "semantic_validator.hpp"
+#include "node_visitor.hpp"
 #include <sstream>
 #include <algorithm>
 #include <set>
 #include <regex>
 
+// Reads the property of block named symbol (or alias, whichever comes last)
+// into text, as value_text() gives it. Returns false, leaving text alone, if
+// the block does not assign it.
+static bool read_property(const BlockStatement* block, std::string& text, Symbol symbol, Symbol alias) {
+    const PropertyStatement* prop = block->find_property(symbol, alias);
+    if (!prop) {
+        return false;
+    }
+    
+    std::string storage;
+    text = value_text(prop->get_value(), storage);
+    return true;
+}
+
+static bool read_property(const BlockStatement* block, std::string& text, Symbol symbol) {
+    return read_property(block, text, symbol, symbol);
+}
+
 // SpecializedSection implementation
-SpecializedSection::SpecializedSection(std::string_view name) noexcept
-    : SectionStatement(name, SectionType::CUSTOM) // Temporarily set as CUSTOM, will be overridden
+SpecializedSection::SpecializedSection(NodeKind kind, std::string_view name) noexcept
+    : SectionStatement(kind, name, SectionType::CUSTOM) // Temporarily set as CUSTOM, will be overridden
 {
 }
 
@@ -18,16 +37,33 @@ std::string SpecializedSection::to_mikrotik(const std::string& ident) const {
 
 // DeviceSection implementation
 DeviceSection::DeviceSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : DeviceSection(NodeKind::DEVICE_SECTION, name)
+{
+}
+
+DeviceSection::DeviceSection(NodeKind kind, std::string_view name) noexcept
+    : SpecializedSection(kind, name)
 {
     // Override the section type
     this->type = SectionType::DEVICE;
 }
 
-std::tuple<bool, std::string> DeviceSection::validate() const noexcept {
+std::tuple<bool, std::string> DeviceSection::validate(SourceSpan& error_span) const noexcept {
     DeviceValidator validator;
-    return validator.validate(get_block());
+    auto result = validator.validate(get_block());
+    error_span = validator.getErrorSpan();
+    return result;
+
+}
 
+// Value of the string property symbol of block ("" if it is missing or not
+// a string), referencing the source text
+static std::string_view string_property(const BlockStatement* block, Symbol symbol) {
+    return block->get_string(symbol).value_or(std::string_view());
+}
+
+std::string DeviceSection::get_hostname() const {
+    return get_block() ? std::string(string_property(get_block(), Symbol::HOSTNAME)) : std::string();
 }
 
 std::string DeviceSection::translate_section(const std::string& ident) const {
@@ -35,50 +71,10 @@ std::string DeviceSection::translate_section(const std::string& ident) const {
     
     if (get_block()) {
         // Extract device properties
-        std::string vendor = "";
-        std::string model = "";
-        std::string hostname = "";
-        
-        // Iterate through statements to find vendor, model, and hostname properties
         const BlockStatement* block = get_block();
-        for (const Statement* stmt : block->get_statements()) {
-            const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(stmt);
-            if (prop) {
-                const std::string& name = prop->get_name();
-                Expression* expr = prop->get_value();
-                
-                if (name == "vendor" && expr) {
-                    const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                    if (value) {
-                        // Remove any quotes from the string value
-                        vendor = value->get_value();
-                        if (vendor.size() >= 2 && vendor.front() == '"' && vendor.back() == '"') {
-                            vendor = vendor.substr(1, vendor.size() - 2);
-                        }
-                    }
-                }
-                else if (name == "model" && expr) {
-                    const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                    if (value) {
-                        // Remove any quotes from the string value
-                        model = value->get_value();
-                        if (model.size() >= 2 && model.front() == '"' && model.back() == '"') {
-                            model = model.substr(1, model.size() - 2);
-                        }
-                    }
-                }
-                else if (name == "hostname" && expr) {
-                    const StringValue* value = dynamic_cast<const StringValue*>(expr);
-                    if (value) {
-                        // Remove any quotes from the string value
-                        hostname = value->get_value();
-                        if (hostname.size() >= 2 && hostname.front() == '"' && hostname.back() == '"') {
-                            hostname = hostname.substr(1, hostname.size() - 2);
-                        }
-                    }
-                }
-            }
-        }
+        std::string_view vendor = string_property(block, Symbol::VENDOR);
+        std::string_view model = string_property(block, Symbol::MODEL);
+        std::string_view hostname = string_property(block, Symbol::HOSTNAME);
         
         // Create the combined name: vendor_hostname_model
         std::string combined_name = "";
@@ -111,15 +107,17 @@ std::string DeviceSection::translate_section(const std::string& ident) const {
 
 // InterfacesSection implementation
 InterfacesSection::InterfacesSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : SpecializedSection(NodeKind::INTERFACES_SECTION, name)
 {
     this->type = SectionType::INTERFACES;
 
 
 }
-std::tuple<bool, std::string> InterfacesSection::validate() const noexcept {
+std::tuple<bool, std::string> InterfacesSection::validate(SourceSpan& error_span) const noexcept {
     InterfacesValidator validator;
-    return validator.validate(get_block());
+    auto result = validator.validate(get_block());
+    error_span = validator.getErrorSpan();
+    return result;
 }
 
 
@@ -127,38 +125,31 @@ std::tuple<bool, std::string> InterfacesSection::validate() const noexcept {
 std::string InterfacesSection::translate_section(const std::string& ident) const {
     std::string result = "# Interface Configuration\n";
 
-    if (get_block()) {
-        const BlockStatement* block = get_block();
-   
-        
-        // 1. First approach - look for subsections within our block (normal case)
-        for (const Statement* stmt : block->get_statements()) {
-            if (const SectionStatement* section = dynamic_cast<const SectionStatement*>(stmt)) {
-                std::string interface_name = section->get_name();
-              
-                
-                // Clean up interface name
-                if (!interface_name.empty() && interface_name.back() == ':') {
-                    interface_name = interface_name.substr(0, interface_name.size() - 1);
-                }
-                
-                // If we somehow still have a colon in the name at this point, try to extract the name part
-                size_t colon_pos = interface_name.find(':');
-                if (colon_pos != std::string::npos) {
-                    interface_name = interface_name.substr(0, colon_pos);
-                }
-                
-                // Ensure interface name is valid
-                if (interface_name.empty()) {
-                    
-                    continue; // Skip invalid interface names
-                }
-                
-                // Process this interface using our helper
-                result += process_interface_section(section, interface_name);
+    // Each subsection is an interface
+    visit_statements(get_block(), overloaded{
+        [&](const SectionStatement& section) {
+            std::string interface_name(section.get_name());
+            
+            // Clean up interface name
+            if (!interface_name.empty() && interface_name.back() == ':') {
+                interface_name = interface_name.substr(0, interface_name.size() - 1);
             }
-        }
-    }
+            
+            // If we somehow still have a colon in the name at this point, try to extract the name part
+            size_t colon_pos = interface_name.find(':');
+            if (colon_pos != std::string::npos) {
+                interface_name = interface_name.substr(0, colon_pos);
+            }
+            
+            // Ensure interface name is valid
+            if (interface_name.empty()) {
+                return; // Skip invalid interface names
+            }
+            
+            // Process this interface using our helper
+            result += process_interface_section(&section, interface_name);
+        },
+        ignore_node{}});
     return result;
 }
 
@@ -184,32 +175,28 @@ std::string InterfacesSection::process_interface_section(const SectionStatement*
     std::map<std::string, std::string> other_props;
     
     // Process all properties in the interface section
-    for (const Statement* prop_stmt : interface_block->get_statements()) {
-        const PropertyStatement* prop = dynamic_cast<const PropertyStatement*>(prop_stmt);
-        if (prop) {
-            const std::string& prop_name = prop->get_name();
-            Expression* expr = prop->get_value();
+    visit_statements(interface_block, overloaded{
+        [&](const PropertyStatement& prop) {
+            std::string_view prop_name = prop.get_name();
+            Symbol prop_symbol = prop.get_symbol();
+            Expression* expr = prop.get_value();
             
             // Extract string value if possible
             std::string value = "";
-            if (const StringValue* str_val = dynamic_cast<const StringValue*>(expr)) {
-                value = str_val->get_value();
-                // Remove quotes if present
-                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                    value = value.substr(1, value.size() - 2);
-                }
-            } else if (const NumberValue* num_val = dynamic_cast<const NumberValue*>(expr)) {
-                value = std::to_string(num_val->get_value());
-            } else if (const BooleanValue* bool_val = dynamic_cast<const BooleanValue*>(expr)) {
-                value = bool_val->get_value() ? "yes" : "no";
+            if (expr) {
+                value = visit_node(*expr, overloaded{
+                    [](const StringValue& str_val) { return std::string(str_val.get_value()); },
+                    [](const NumberValue& num_val) { return std::to_string(num_val.get_value()); },
+                    [](const BooleanValue& bool_val) { return std::string(bool_val.get_value() ? "yes" : "no"); },
+                    [](const ASTNodeInterface&) { return std::string(); }});
             }
             
             // Store property values
-            if (prop_name == "type") {
+            if (prop_symbol == Symbol::TYPE) {
                 type = value;
-            } else if (prop_name == "mtu") {
+            } else if (prop_symbol == Symbol::MTU) {
                 mtu = value;
-            } else if (prop_name == "disabled" || prop_name == "admin_state") {
+            } else if (prop_symbol == Symbol::DISABLED || prop_symbol == Symbol::ADMIN_STATE) {
                 // Map admin_state to disabled 
                 if (value == "enabled") {
                     disabled = "no";  // not disabled = enabled
@@ -218,21 +205,21 @@ std::string InterfacesSection::process_interface_section(const SectionStatement*
                 } else {
                     disabled = value; // use as-is if not a recognized value
                 }
-            } else if (prop_name == "mac_address" || prop_name == "mac") {
+            } else if (prop_symbol == Symbol::MAC_ADDRESS || prop_symbol == Symbol::MAC) {
                 mac_address = value;
-            } else if (prop_name == "comment") {
+            } else if (prop_symbol == Symbol::COMMENT) {
                 comment = value;
-            } else if (prop_name == "description") {
+            } else if (prop_symbol == Symbol::DESCRIPTION) {
                 description = value;
-            } else if (prop_name == "vlan_id") {
+            } else if (prop_symbol == Symbol::VLAN_ID) {
                 vlan_id = value;
-            } else if (prop_name == "interface") {
+            } else if (prop_symbol == Symbol::INTERFACE) {
                 parent_interface = value;
             } else {
-                other_props[prop_name] = value;
+                other_props[std::string(prop_name)] = value;
             }
-        }
-    }
+        },
+        ignore_node{}});
     
     // If description is set but comment is not, use description as comment
     if (comment.empty() && !description.empty()) {
@@ -388,361 +375,368 @@ std::string InterfacesSection::process_interface_section(const SectionStatement*
 
 // IPSection implementation
 IPSection::IPSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : SpecializedSection(NodeKind::IP_SECTION, name)
 {
     this->type = SectionType::IP;
 }
 
-std::tuple<bool, std::string> IPSection::validate() const noexcept {
+std::tuple<bool, std::string> IPSection::validate(SourceSpan& error_span) const noexcept {
     IPValidator validator;
-    return validator.validate(get_block());
+    auto result = validator.validate(get_block());
+    error_span = validator.getErrorSpan();
+    return result;
 }
 
 std::string IPSection::translate_section(const std::string& ident) const {
-    std::string result = ident + "# IP Configuration: " + get_name() + "\n";
+    std::string result = ident + "# IP Configuration: " + std::string(get_name()) + "\n";
     
-    if (get_block()) {
-        const BlockStatement* block = get_block();
-        
-        // Process each statement in the IP section
-        for (const auto* stmt : block->get_statements()) {
-            // Check if this is a section (interface, route, firewall, etc.)
-            if (const auto* subsection = dynamic_cast<const SectionStatement*>(stmt)) {
-                std::string subsection_name = subsection->get_name();
-                
-                // Handle different IP subsections based on name
-                if (subsection_name == "route" || subsection_name == "routes") {
-                    // Handle IP routes
-                    if (subsection->get_block()) {
-                        for (const auto* route_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* route_prop = dynamic_cast<const PropertyStatement*>(route_stmt)) {
-                                if (route_prop->get_name() == "default" && route_prop->get_value()) {
-                                    // Default route
-                                    std::string gateway = route_prop->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                                        gateway = gateway.substr(1, gateway.size() - 2);
-                                    }
-                                    result += "/ip route add dst-address=0.0.0.0/0 gateway=" + gateway + "\n";
-                                }
-                            } else if (const auto* route_section = dynamic_cast<const SectionStatement*>(route_stmt)) {
-                                // Handle specific route entries
-                                std::string dst_address = route_section->get_name();
-                                std::string gateway = "";
-                                std::string distance = "";
-                                
-                                if (route_section->get_block()) {
-                                    for (const auto* route_detail : route_section->get_block()->get_statements()) {
-                                        if (const auto* detail_prop = dynamic_cast<const PropertyStatement*>(route_detail)) {
-                                            if (detail_prop->get_name() == "gateway" && detail_prop->get_value()) {
-                                                gateway = detail_prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                                                    gateway = gateway.substr(1, gateway.size() - 2);
-                                                }
-                                            } else if (detail_prop->get_name() == "distance" && detail_prop->get_value()) {
-                                                distance = detail_prop->get_value()->to_mikrotik("");
-                                            }
-                                        }
-                                    }
-                                }
-                                
-                                if (!gateway.empty()) {
-                                    result += "/ip route add dst-address=" + dst_address;
-                                    result += " gateway=" + gateway;
-                                    if (!distance.empty()) {
-                                        result += " distance=" + distance;
-                                    }
-                                    result += "\n";
-                                }
-                            }
+    // Process each subsection of the IP section (interface, route, firewall, etc.)
+    visit_statements(get_block(), overloaded{
+        [&](const SectionStatement& subsection) {
+            std::string subsection_name(subsection.get_name());
+            Symbol subsection_symbol = subsection.get_symbol();
+            
+            // Handle different IP subsections based on name
+            if (subsection_symbol == Symbol::ROUTE || subsection_symbol == Symbol::ROUTES) {
+                // Handle IP routes
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const PropertyStatement& route_prop) {
+                        if (route_prop.get_symbol() == Symbol::DEFAULT && route_prop.get_value()) {
+                            // Default route
+                            std::string storage;
+                            result += "/ip route add dst-address=0.0.0.0/0 gateway=";
+                            result += value_text(route_prop.get_value(), storage);
+                            result += "\n";
                         }
-                    }
-                } else if (subsection_name == "firewall") {
-                    // Handle firewall rules
-                    if (subsection->get_block()) {
-                        for (const auto* fw_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* fw_section = dynamic_cast<const SectionStatement*>(fw_stmt)) {
-                                std::string chain_name = fw_section->get_name();
-                                
-                                // Process filter or nat chains
-                                if (chain_name == "filter" || chain_name == "nat") {
-                                    if (fw_section->get_block()) {
-                                        for (const auto* rule_stmt : fw_section->get_block()->get_statements()) {
-                                            if (const auto* rule_section = dynamic_cast<const SectionStatement*>(rule_stmt)) {
-                                                std::string rule_chain = rule_section->get_name();
-                                                std::string action = "";
-                                                std::string protocol = "";
-                                                std::string dst_port = "";
-                                                std::string dst_address = "";
-                                                std::string src_address = "";
-                                                std::string out_interface = "";
-                                                std::string in_interface = "";
-                                                
-                                                if (rule_section->get_block()) {
-                                                    for (const auto* rule_prop : rule_section->get_block()->get_statements()) {
-                                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(rule_prop)) {
-                                                            std::string prop_name = prop->get_name();
-                                                            std::string value = "";
-                                                            if (prop->get_value()) {
-                                                                value = prop->get_value()->to_mikrotik("");
-                                                                // Remove quotes if present
-                                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                                    value = value.substr(1, value.size() - 2);
-                                                                }
-                                                            }
-                                                            
-                                                            if (prop_name == "action") action = value;
-                                                            else if (prop_name == "protocol") protocol = value;
-                                                            else if (prop_name == "dst-port") dst_port = value;
-                                                            else if (prop_name == "dst-address") dst_address = value;
-                                                            else if (prop_name == "src-address") src_address = value;
-                                                            else if (prop_name == "out-interface") out_interface = value;
-                                                            else if (prop_name == "in-interface") in_interface = value;
-                                                        }
-                                                    }
-                                                }
-                                                
-                                                // Generate firewall rule
-                                                if (!action.empty()) {
-                                                    result += "/ip firewall " + chain_name + " add chain=" + rule_chain;
-                                                    result += " action=" + action;
-                                                    if (!protocol.empty()) result += " protocol=" + protocol;
-                                                    if (!dst_port.empty()) result += " dst-port=" + dst_port;
-                                                    if (!dst_address.empty()) result += " dst-address=" + dst_address;
-                                                    if (!src_address.empty()) result += " src-address=" + src_address;
-                                                    if (!out_interface.empty()) result += " out-interface=" + out_interface;
-                                                    if (!in_interface.empty()) result += " in-interface=" + in_interface;
-                                                    result += "\n";
-                                                }
-                                            }
-                                        }
-                                    }
+                    },
+                    [&](const SectionStatement& route_section) {
+                        // Handle specific route entries
+                        std::string dst_address(route_section.get_name());
+                        std::string gateway = "";
+                        std::string distance = "";
+                        
+                        visit_statements(route_section.get_block(), overloaded{
+                            [&](const PropertyStatement& detail_prop) {
+                                if (detail_prop.get_symbol() == Symbol::GATEWAY && detail_prop.get_value()) {
+                                    std::string storage;
+                                    gateway = value_text(detail_prop.get_value(), storage);
+                                } else if (detail_prop.get_symbol() == Symbol::DISTANCE && detail_prop.get_value()) {
+                                    distance = detail_prop.get_value()->to_mikrotik("");
                                 }
+                            },
+                            ignore_node{}});
+                        
+                        if (!gateway.empty()) {
+                            result += "/ip route add dst-address=" + dst_address;
+                            result += " gateway=" + gateway;
+                            if (!distance.empty()) {
+                                result += " distance=" + distance;
                             }
+                            result += "\n";
                         }
-                    }
-                } else if (subsection_name == "dhcp-server") {
-                    // Handle DHCP server configuration
-                    if (subsection->get_block()) {
-                        for (const auto* dhcp_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* dhcp_section = dynamic_cast<const SectionStatement*>(dhcp_stmt)) {
-                                std::string dhcp_name = dhcp_section->get_name();
-                                std::string interface = "";
-                                std::string address_pool = "";
-                                std::string lease_time = "";
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::FIREWALL) {
+                // Handle firewall rules of the filter or nat chains
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const SectionStatement& fw_section) {
+                        std::string chain_name(fw_section.get_name());
+                        Symbol chain_symbol = fw_section.get_symbol();
+                        if (chain_symbol != Symbol::FILTER && chain_symbol != Symbol::NAT) {
+                            return;
+                        }
+                        
+                        visit_statements(fw_section.get_block(), overloaded{
+                            [&](const SectionStatement& rule_section) {
+                                std::string rule_chain(rule_section.get_name());
+                                std::string action = "";
+                                std::string protocol = "";
+                                std::string dst_port = "";
+                                std::string dst_address = "";
+                                std::string src_address = "";
+                                std::string out_interface = "";
+                                std::string in_interface = "";
                                 
-                                if (dhcp_section->get_block()) {
-                                    for (const auto* dhcp_prop : dhcp_section->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(dhcp_prop)) {
-                                            std::string prop_name = prop->get_name();
-                                            std::string value = "";
-                                            if (prop->get_value()) {
-                                                value = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                }
-                                            }
-                                            
-                                            if (prop_name == "interface") interface = value;
-                                            else if (prop_name == "address-pool") address_pool = value;
-                                            else if (prop_name == "lease-time") lease_time = value;
+                                visit_statements(rule_section.get_block(), overloaded{
+                                    [&](const PropertyStatement& prop) {
+                                        Symbol prop_symbol = prop.get_symbol();
+                                        std::string storage;
+                                        std::string_view value;
+                                        if (prop.get_value()) {
+                                            value = value_text(prop.get_value(), storage);
                                         }
-                                    }
-                                }
+                                        
+                                        if (prop_symbol == Symbol::ACTION) action = value;
+                                        else if (prop_symbol == Symbol::PROTOCOL) protocol = value;
+                                        else if (prop_symbol == Symbol::DST_PORT_DASHED) dst_port = value;
+                                        else if (prop_symbol == Symbol::DST_ADDRESS_DASHED) dst_address = value;
+                                        else if (prop_symbol == Symbol::SRC_ADDRESS_DASHED) src_address = value;
+                                        else if (prop_symbol == Symbol::OUT_INTERFACE_DASHED) out_interface = value;
+                                        else if (prop_symbol == Symbol::IN_INTERFACE_DASHED) in_interface = value;
+                                    },
+                                    ignore_node{}});
                                 
-                                // Generate DHCP server
-                                if (!interface.empty()) {
-                                    result += "/ip dhcp-server add name=" + dhcp_name;
-                                    result += " interface=" + interface;
-                                    if (!address_pool.empty()) result += " address-pool=" + address_pool;
-                                    if (!lease_time.empty()) result += " lease-time=" + lease_time;
+                                // Generate firewall rule
+                                if (!action.empty()) {
+                                    result += "/ip firewall " + chain_name + " add chain=" + rule_chain;
+                                    result += " action=" + action;
+                                    if (!protocol.empty()) result += " protocol=" + protocol;
+                                    if (!dst_port.empty()) result += " dst-port=" + dst_port;
+                                    if (!dst_address.empty()) result += " dst-address=" + dst_address;
+                                    if (!src_address.empty()) result += " src-address=" + src_address;
+                                    if (!out_interface.empty()) result += " out-interface=" + out_interface;
+                                    if (!in_interface.empty()) result += " in-interface=" + in_interface;
                                     result += "\n";
                                 }
-                            }
-                        }
-                    }
-                } else if (subsection_name == "dhcp-client") {
-                    // Handle DHCP client configuration
-                    if (subsection->get_block()) {
-                        for (const auto* dhcp_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* dhcp_prop = dynamic_cast<const PropertyStatement*>(dhcp_stmt)) {
-                                std::string interface = dhcp_prop->get_name();
-                                std::string disabled = "no"; // Enable by default
-                                
-                                if (dhcp_prop->get_value()) {
-                                    std::string value = dhcp_prop->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                        value = value.substr(1, value.size() - 2);
-                                    }
-                                    
-                                    if (value == "false" || value == "no") {
-                                        disabled = "yes";
-                                    }
+                            },
+                            ignore_node{}});
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::DHCP_SERVER_DASHED) {
+                // Handle DHCP server configuration
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const SectionStatement& dhcp_section) {
+                        std::string dhcp_name(dhcp_section.get_name());
+                        std::string interface = "";
+                        std::string address_pool = "";
+                        std::string lease_time = "";
+                        
+                        visit_statements(dhcp_section.get_block(), overloaded{
+                            [&](const PropertyStatement& prop) {
+                                Symbol prop_symbol = prop.get_symbol();
+                                std::string storage;
+                                std::string_view value;
+                                if (prop.get_value()) {
+                                    value = value_text(prop.get_value(), storage);
                                 }
                                 
-                                result += "/ip dhcp-client add interface=" + interface;
-                                result += " disabled=" + disabled + "\n";
-                            }
+                                if (prop_symbol == Symbol::INTERFACE) interface = value;
+                                else if (prop_symbol == Symbol::ADDRESS_POOL_DASHED) address_pool = value;
+                                else if (prop_symbol == Symbol::LEASE_TIME_DASHED) lease_time = value;
+                            },
+                            ignore_node{}});
+                        
+                        // Generate DHCP server
+                        if (!interface.empty()) {
+                            result += "/ip dhcp-server add name=" + dhcp_name;
+                            result += " interface=" + interface;
+                            if (!address_pool.empty()) result += " address-pool=" + address_pool;
+                            if (!lease_time.empty()) result += " lease-time=" + lease_time;
+                            result += "\n";
                         }
-                    }
-                } else if (subsection_name == "dns") {
-                    // Handle DNS configuration
-                    std::string servers = "";
-                    std::string allow_remote = "";
-                     
-                    if (subsection->get_block()) {
-                        for (const auto* dns_prop : subsection->get_block()->get_statements()) {
-                            if (const auto* prop = dynamic_cast<const PropertyStatement*>(dns_prop)) {
-                                std::string prop_name = prop->get_name();
-                                std::string value = "";
-                                if (prop->get_value()) {
-                                    value = prop->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                        value = value.substr(1, value.size() - 2);
-                                    }
-                                }
-                                
-                                if (prop_name == "servers") servers = value;
-                                else if (prop_name == "allow-remote-requests") allow_remote = value;
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::DHCP_CLIENT_DASHED) {
+                // Handle DHCP client configuration, a property per interface
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const PropertyStatement& dhcp_prop) {
+                        std::string interface(dhcp_prop.get_name());
+                        std::string disabled = "no"; // Enable by default
+                        
+                        if (dhcp_prop.get_value()) {
+                            std::string storage;
+                            std::string_view value = value_text(dhcp_prop.get_value(), storage);
+                            
+                            if (value == "false" || value == "no") {
+                                disabled = "yes";
                             }
                         }
-                    }
-                    
-                    // Generate DNS configuration
-                    if (!servers.empty() || !allow_remote.empty()) {
-                        result += "/ip dns set";
-                        if (!servers.empty()) result += " servers=" + servers;
-                        if (!allow_remote.empty()) result += " allow-remote-requests=" + allow_remote;
-                        result += "\n";
-                    }
-                } else {
-                    // Process as an interface with IP addresses (default case)
-                    std::string interface_name = subsection_name;
-                    
-                    // Process the IP configuration for this interface
-                    if (subsection->get_block()) {
-                        for (const auto* ip_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* ip_prop = dynamic_cast<const PropertyStatement*>(ip_stmt)) {
-                                if (ip_prop->get_name() == "address" && ip_prop->get_value()) {
-                                    std::string ip_value = ip_prop->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (ip_value.size() >= 2 && ip_value.front() == '"' && ip_value.back() == '"') {
-                                        ip_value = ip_value.substr(1, ip_value.size() - 2);
-                                    }
-                                    
-                                    // Generate /ip address add command
-                                    result += "/ip address add address=" + ip_value + 
-                                              " interface=" + interface_name + "\n";
-                                }
-                            }
+                        
+                        result += "/ip dhcp-client add interface=" + interface;
+                        result += " disabled=" + disabled + "\n";
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::DNS) {
+                // Handle DNS configuration
+                std::string servers = "";
+                std::string allow_remote = "";
+                
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const PropertyStatement& prop) {
+                        Symbol prop_symbol = prop.get_symbol();
+                        std::string storage;
+                        std::string_view value;
+                        if (prop.get_value()) {
+                            value = value_text(prop.get_value(), storage);
                         }
-                    }
+                        
+                        if (prop_symbol == Symbol::SERVERS) servers = value;
+                        else if (prop_symbol == Symbol::ALLOW_REMOTE_REQUESTS_DASHED) allow_remote = value;
+                    },
+                    ignore_node{}});
+                
+                // Generate DNS configuration
+                if (!servers.empty() || !allow_remote.empty()) {
+                    result += "/ip dns set";
+                    if (!servers.empty()) result += " servers=" + servers;
+                    if (!allow_remote.empty()) result += " allow-remote-requests=" + allow_remote;
+                    result += "\n";
                 }
-            } else if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(stmt)) {
-                // Handle top-level IP properties (direct properties under the ip: section)
-                // This could be for global IP settings or simple configurations
-                std::string prop_name = prop_stmt->get_name();
+            } else {
+                // Process as an interface with IP addresses (default case)
+                const std::string& interface_name = subsection_name;
                 
-                if (prop_name == "arp") {
-                    // Handle static ARP entries
-                    if (prop_stmt->get_value()) {
-                        // Check if this is a section statement containing ARP entries
-                        const SectionStatement* arp_section = dynamic_cast<const SectionStatement*>(prop_stmt->get_value());
-                        if (arp_section && arp_section->get_block()) {
-                            const BlockStatement* arp_block = arp_section->get_block();
-                            for (const auto* arp_stmt : arp_block->get_statements()) {
-                                if (const auto* arp_prop = dynamic_cast<const PropertyStatement*>(arp_stmt)) {
-                                    std::string ip_address = arp_prop->get_name();
-                                    std::string mac_address = "";
-                                    std::string interface = "";
-                                    
-                                    // Handle the ARP entry properties
-                                    if (arp_prop->get_value()) {
-                                        // Try to get MAC and interface from nested section
-                                        const SectionStatement* mac_section = dynamic_cast<const SectionStatement*>(arp_prop->get_value());
-                                        if (mac_section && mac_section->get_block()) {
-                                            for (const auto* mac_stmt : mac_section->get_block()->get_statements()) {
-                                                if (const auto* mac_prop = dynamic_cast<const PropertyStatement*>(mac_stmt)) {
-                                                    if (mac_prop->get_name() == "mac-address" && mac_prop->get_value()) {
-                                                        mac_address = mac_prop->get_value()->to_mikrotik("");
-                                                    } else if (mac_prop->get_name() == "interface" && mac_prop->get_value()) {
-                                                        interface = mac_prop->get_value()->to_mikrotik("");
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                    
-                                    if (!mac_address.empty() && !interface.empty()) {
-                                        // Remove quotes if present
-                                        if (mac_address.size() >= 2 && mac_address.front() == '"' && mac_address.back() == '"') {
-                                            mac_address = mac_address.substr(1, mac_address.size() - 2);
-                                        }
-                                        if (interface.size() >= 2 && interface.front() == '"' && interface.back() == '"') {
-                                            interface = interface.substr(1, interface.size() - 2);
-                                        }
-                                        
-                                        result += "/ip arp add address=" + ip_address;
-                                        result += " mac-address=" + mac_address;
-                                        result += " interface=" + interface + "\n";
-                                    }
-                                }
-                            }
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const PropertyStatement& ip_prop) {
+                        if (ip_prop.get_symbol() == Symbol::ADDRESS && ip_prop.get_value()) {
+                            std::string storage;
+                            
+                            // Generate /ip address add command
+                            result += "/ip address add address=";
+                            result += value_text(ip_prop.get_value(), storage);
+                            result += " interface=" + interface_name + "\n";
                         }
-                    }
-                }
+                    },
+                    ignore_node{}});
             }
-        }
-    }
+        },
+        // Properties directly under the IP section are not translated
+        ignore_node{}});
     
     return result;
 }
 
 // RoutingSection implementation
 RoutingSection::RoutingSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : SpecializedSection(NodeKind::ROUTING_SECTION, name)
 {
     this->type = SectionType::ROUTING;
 }
 
-std::tuple<bool, std::string> RoutingSection::validate() const noexcept {
+std::tuple<bool, std::string> RoutingSection::validate(SourceSpan& error_span) const noexcept {
     RoutingValidator validator;
-    return validator.validate(get_block());
+    auto result = validator.validate(get_block());
+    error_span = validator.getErrorSpan();
+    return result;
 }
 
 std::string RoutingSection::translate_section(const std::string& ident) const {
-    std::string result = ident + "# Routing Configuration: " + get_name() + "\n";
+    std::string result = ident + "# Routing Configuration: " + std::string(get_name()) + "\n";
     
-    if (get_block()) {
-        const BlockStatement* block = get_block();
-        
-        // Process each statement in the routing section
-        for (const auto* stmt : block->get_statements()) {
-            // Handle properties vs subsections differently
-            if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(stmt)) {
-                // Handle properties like default gateway
-                std::string prop_name = prop_stmt->get_name();
+    // Process each statement in the routing section, properties and
+    // subsections differently
+    visit_statements(get_block(), overloaded{
+        [&](const PropertyStatement& prop_stmt) {
+            // Handle properties like default gateway
+            Symbol prop_symbol = prop_stmt.get_symbol();
+            
+            if (prop_symbol == Symbol::STATIC_ROUTE_DEFAULT_GW && prop_stmt.get_value()) {
+                // Default route
+                std::string storage;
                 
-                if (prop_name == "static_route_default_gw" && prop_stmt->get_value()) {
-                    // Default route
-                    std::string gateway = prop_stmt->get_value()->to_mikrotik("");
-                    // Remove quotes if present
-                    if (gateway.size() >= 2 && gateway.front() == '"' && gateway.back() == '"') {
-                        gateway = gateway.substr(1, gateway.size() - 2);
-                    }
-                    
-                    // Generate default route
-                    result += "/ip route add dst-address=0.0.0.0/0 gateway=" + gateway + "\n";
-                }
-            } else if (const auto* route_section = dynamic_cast<const SectionStatement*>(stmt)) {
+                // Generate default route
+                result += "/ip route add dst-address=0.0.0.0/0 gateway=";
+                result += value_text(prop_stmt.get_value(), storage);
+                result += "\n";
+            }
+        },
+        [&](const SectionStatement& subsection) {
+            Symbol subsection_symbol = subsection.get_symbol();
+            
+            // Handle specific routing subsections like 'table', 'rule', etc.
+            if (subsection_symbol == Symbol::TABLE || subsection_symbol == Symbol::TABLES) {
+                // Handle routing tables
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const SectionStatement& table_section) {
+                        std::string table_name(table_section.get_name());
+                        bool fib = true; // Default in RouterOS v7
+                        
+                        visit_statements(table_section.get_block(), overloaded{
+                            [&](const PropertyStatement& prop) {
+                                if (prop.get_symbol() == Symbol::FIB && prop.get_value()) {
+                                    std::string value = prop.get_value()->to_mikrotik("");
+                                    if (value == "no" || value == "false") {
+                                        fib = false;
+                                    }
+                                }
+                            },
+                            ignore_node{}});
+                        
+                        // Generate routing table
+                        result += "/routing table add name=" + table_name;
+                        if (fib) {
+                            result += " fib";
+                        }
+                        result += "\n";
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::RULE || subsection_symbol == Symbol::RULES) {
+                // Handle routing rules
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const SectionStatement& rule_section) {
+                        std::string src_address = "";
+                        std::string dst_address = "";
+                        std::string interface = "";
+                        std::string action = "";
+                        std::string table = "";
+                        
+                        visit_statements(rule_section.get_block(), overloaded{
+                            [&](const PropertyStatement& prop) {
+                                Symbol prop_symbol = prop.get_symbol();
+                                std::string storage;
+                                std::string_view value;
+                                
+                                if (prop.get_value()) {
+                                    value = value_text(prop.get_value(), storage);
+                                }
+                                
+                                if (prop_symbol == Symbol::SRC_ADDRESS_DASHED) {
+                                    src_address = value;
+                                } else if (prop_symbol == Symbol::DST_ADDRESS_DASHED) {
+                                    dst_address = value;
+                                } else if (prop_symbol == Symbol::INTERFACE) {
+                                    interface = value;
+                                } else if (prop_symbol == Symbol::ACTION) {
+                                    action = value;
+                                } else if (prop_symbol == Symbol::TABLE) {
+                                    table = value;
+                                }
+                            },
+                            ignore_node{}});
+                        
+                        // Generate routing rule
+                        result += "/routing rule add";
+                        if (!src_address.empty()) {
+                            result += " src-address=" + src_address;
+                        }
+                        if (!dst_address.empty()) {
+                            result += " dst-address=" + dst_address;
+                        }
+                        if (!interface.empty()) {
+                            result += " interface=" + interface;
+                        }
+                        if (!action.empty()) {
+                            result += " action=" + action;
+                        }
+                        if (!table.empty()) {
+                            result += " table=" + table;
+                        }
+                        result += "\n";
+                    },
+                    ignore_node{}});
+            } else if (subsection_symbol == Symbol::FILTER) {
+                // Handle routing filters for v7
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const SectionStatement& filter_section) {
+                        std::string chain_name(filter_section.get_name());
+                        
+                        visit_statements(filter_section.get_block(), overloaded{
+                            [&](const PropertyStatement& prop) {
+                                if (prop.get_symbol() == Symbol::RULE && prop.get_value()) {
+                                    std::string storage;
+                                    
+                                    // Generate routing filter rule
+                                    result += "/routing/filter/rule add chain=" + chain_name;
+                                    result += " rule=\"";
+                                    result += value_text(prop.get_value(), storage);
+                                    result += "\"\n";
+                                }
+                            },
+                            ignore_node{}});
+                    },
+                    ignore_node{}});
+            } else {
                 // Handle named route sections (static_route1, etc.)
-                std::string route_name = route_section->get_name();
-                
-                // Extract route properties
                 std::string destination = "";
                 std::string gateway = "";
                 std::string distance = "";
@@ -752,40 +746,36 @@ std::string RoutingSection::translate_section(const std::string& ident) const {
                 std::string target_scope = "";
                 bool suppress_hw_offload = false;
                 
-                if (route_section->get_block()) {
-                    for (const auto* route_prop : route_section->get_block()->get_statements()) {
-                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(route_prop)) {
-                            std::string prop_name = prop->get_name();
-                            std::string value = "";
-                            
-                            if (prop->get_value()) {
-                                value = prop->get_value()->to_mikrotik("");
-                                // Remove quotes if present
-                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                    value = value.substr(1, value.size() - 2);
-                                }
-                            }
-                            
-                            if (prop_name == "destination" || prop_name == "dst-address" || prop_name == "dst") {
-                                destination = value;
-                            } else if (prop_name == "gateway" || prop_name == "gw") {
-                                gateway = value;
-                            } else if (prop_name == "distance") {
-                                distance = value;
-                            } else if (prop_name == "routing-table" || prop_name == "table") {
-                                routing_table = value;
-                            } else if (prop_name == "check-gateway") {
-                                check_gateway = value;
-                            } else if (prop_name == "scope") {
-                                scope = value;
-                            } else if (prop_name == "target-scope") {
-                                target_scope = value;
-                            } else if (prop_name == "suppress-hw-offload") {
-                                suppress_hw_offload = (value == "yes" || value == "true");
-                            }
+                // Extract route properties
+                visit_statements(subsection.get_block(), overloaded{
+                    [&](const PropertyStatement& prop) {
+                        Symbol prop_symbol = prop.get_symbol();
+                        std::string storage;
+                        std::string_view value;
+                        
+                        if (prop.get_value()) {
+                            value = value_text(prop.get_value(), storage);
                         }
-                    }
-                }
+                        
+                        if (prop_symbol == Symbol::DESTINATION || prop_symbol == Symbol::DST_ADDRESS_DASHED || prop_symbol == Symbol::DST) {
+                            destination = value;
+                        } else if (prop_symbol == Symbol::GATEWAY || prop_symbol == Symbol::GW) {
+                            gateway = value;
+                        } else if (prop_symbol == Symbol::DISTANCE) {
+                            distance = value;
+                        } else if (prop_symbol == Symbol::ROUTING_TABLE_DASHED || prop_symbol == Symbol::TABLE) {
+                            routing_table = value;
+                        } else if (prop_symbol == Symbol::CHECK_GATEWAY_DASHED) {
+                            check_gateway = value;
+                        } else if (prop_symbol == Symbol::SCOPE) {
+                            scope = value;
+                        } else if (prop_symbol == Symbol::TARGET_SCOPE_DASHED) {
+                            target_scope = value;
+                        } else if (prop_symbol == Symbol::SUPPRESS_HW_OFFLOAD_DASHED) {
+                            suppress_hw_offload = (value == "yes" || value == "true");
+                        }
+                    },
+                    ignore_node{}});
                 
                 // Generate a static route if we have at least a destination and gateway
                 if (!destination.empty() && !gateway.empty()) {
@@ -814,561 +804,354 @@ std::string RoutingSection::translate_section(const std::string& ident) const {
                     
                     result += "\n";
                 }
-            } else if (const auto* subsection = dynamic_cast<const SectionStatement*>(stmt)) {
-                // Handle specific routing subsections like 'table', 'rule', etc.
-                std::string subsection_name = subsection->get_name();
-                
-                if (subsection_name == "table" || subsection_name == "tables") {
-                    // Handle routing tables
-                    if (subsection->get_block()) {
-                        for (const auto* table_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* table_section = dynamic_cast<const SectionStatement*>(table_stmt)) {
-                                std::string table_name = table_section->get_name();
-                                bool fib = true; // Default in RouterOS v7
-                                
-                                if (table_section->get_block()) {
-                                    for (const auto* table_prop : table_section->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(table_prop)) {
-                                            if (prop->get_name() == "fib" && prop->get_value()) {
-                                                std::string value = prop->get_value()->to_mikrotik("");
-                                                if (value == "no" || value == "false") {
-                                                    fib = false;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                                
-                                // Generate routing table
-                                result += "/routing table add name=" + table_name;
-                                if (fib) {
-                                    result += " fib";
-                                }
-                                result += "\n";
-                            }
-                        }
-                    }
-                } else if (subsection_name == "rule" || subsection_name == "rules") {
-                    // Handle routing rules
-                    if (subsection->get_block()) {
-                        for (const auto* rule_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* rule_section = dynamic_cast<const SectionStatement*>(rule_stmt)) {
-                                std::string rule_name = rule_section->get_name();
-                                std::string src_address = "";
-                                std::string dst_address = "";
-                                std::string interface = "";
-                                std::string action = "";
-                                std::string table = "";
-                                
-                                if (rule_section->get_block()) {
-                                    for (const auto* rule_prop : rule_section->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(rule_prop)) {
-                                            std::string prop_name = prop->get_name();
-                                            std::string value = "";
-                                            
-                                            if (prop->get_value()) {
-                                                value = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                }
-                                            }
-                                            
-                                            if (prop_name == "src-address") {
-                                                src_address = value;
-                                            } else if (prop_name == "dst-address") {
-                                                dst_address = value;
-                                            } else if (prop_name == "interface") {
-                                                interface = value;
-                                            } else if (prop_name == "action") {
-                                                action = value;
-                                            } else if (prop_name == "table") {
-                                                table = value;
-                                            }
-                                        }
-                                    }
-                                }
-                                
-                                // Generate routing rule
-                                result += "/routing rule add";
-                                if (!src_address.empty()) {
-                                    result += " src-address=" + src_address;
-                                }
-                                if (!dst_address.empty()) {
-                                    result += " dst-address=" + dst_address;
-                                }
-                                if (!interface.empty()) {
-                                    result += " interface=" + interface;
-                                }
-                                if (!action.empty()) {
-                                    result += " action=" + action;
-                                }
-                                if (!table.empty()) {
-                                    result += " table=" + table;
-                                }
-                                result += "\n";
-                            }
-                        }
-                    }
-                } else if (subsection_name == "filter") {
-                    // Handle routing filters for v7
-                    if (subsection->get_block()) {
-                        for (const auto* filter_stmt : subsection->get_block()->get_statements()) {
-                            if (const auto* filter_section = dynamic_cast<const SectionStatement*>(filter_stmt)) {
-                                std::string chain_name = filter_section->get_name();
-                                std::string rule = "";
-                                
-                                if (filter_section->get_block()) {
-                                    for (const auto* filter_prop : filter_section->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(filter_prop)) {
-                                            if (prop->get_name() == "rule" && prop->get_value()) {
-                                                rule = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (rule.size() >= 2 && rule.front() == '"' && rule.back() == '"') {
-                                                    rule = rule.substr(1, rule.size() - 2);
-                                                }
-                                                
-                                                // Generate routing filter rule
-                                                result += "/routing/filter/rule add chain=" + chain_name;
-                                                result += " rule=\"" + rule + "\"\n";
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
             }
-        }
-    }
+        },
+        ignore_node{}});
     
     return result;
 }
 
 // FirewallSection implementation
 FirewallSection::FirewallSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : SpecializedSection(NodeKind::FIREWALL_SECTION, name)
 {
     this->type = SectionType::FIREWALL;
 }
 
-std::tuple<bool, std::string> FirewallSection::validate() const noexcept {
+std::tuple<bool, std::string> FirewallSection::validate(SourceSpan& error_span) const noexcept {
     FirewallValidator validator;
-    return validator.validate(get_block());
+    auto result = validator.validate(get_block());
+    error_span = validator.getErrorSpan();
+    return result;
 }
 
 std::string FirewallSection::translate_section(const std::string& ident) const {
-    std::string result = ident + "# Firewall Configuration: " + get_name() + "\n";
+    std::string result = ident + "# Firewall Configuration: " + std::string(get_name()) + "\n";
     
-    if (get_block()) {
-        const BlockStatement* block = get_block();
-        
-        // Process each subsection (filter, nat, etc.)
-        for (const auto* stmt : block->get_statements()) {
-            if (const auto* section = dynamic_cast<const SectionStatement*>(stmt)) {
-                std::string section_name = section->get_name();
-                
-                // Process filter rules
-                if (section_name == "filter") {
-                    if (section->get_block()) {
-                        for (const auto* rule_stmt : section->get_block()->get_statements()) {
-                            if (const auto* rule = dynamic_cast<const SectionStatement*>(rule_stmt)) {
-                                std::string rule_name = rule->get_name();
-                                std::string chain = "forward"; // Default chain
-                                std::string action = "";
-                                std::string connection_state = "";
-                                std::string protocol = "";
-                                std::string src_address = "";
-                                std::string dst_address = "";
-                                std::string src_port = "";
-                                std::string dst_port = "";
-                                std::string in_interface = "";
-                                std::string out_interface = "";
-                                std::string comment = rule_name;
-                                
-                                // Extract properties for this filter rule
-                                if (rule->get_block()) {
-                                    for (const auto* prop_stmt : rule->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(prop_stmt)) {
-                                            std::string prop_name = prop->get_name();
-                                            std::string value = "";
-                                            
-                                            if (prop->get_value()) {
-                                                value = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                }
-                                            }
-                                            
-                                            if (prop_name == "chain") {
-                                                chain = value;
-                                            } else if (prop_name == "action") {
-                                                action = value;
-                                            } else if (prop_name == "connection_state" || prop_name == "connection-state") {
-                                                // Handle array of states like ["established", "related"]
-                                                if (value.front() == '[' && value.back() == ']') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                    std::string state;
-                                                    std::stringstream ss(value);
-                                                    bool first = true;
-                                                    
-                                                    while (ss >> state) {
-                                                        // Clean up state - remove quotes and commas
-                                                        state.erase(remove(state.begin(), state.end(), '"'), state.end());
-                                                        state.erase(remove(state.begin(), state.end(), ','), state.end());
-                                                        
-                                                        if (!state.empty()) {
-                                                            if (first) {
-                                                                connection_state = state;
-                                                                first = false;
-                                                            } else {
-                                                                connection_state += "," + state;
-                                                            }
-                                                        }
-                                                    }
-                                                } else {
-                                                    connection_state = value;
-                                                }
-                                            } else if (prop_name == "protocol") {
-                                                protocol = value;
-                                            } else if (prop_name == "src_address" || prop_name == "src-address") {
-                                                src_address = value;
-                                            } else if (prop_name == "dst_address" || prop_name == "dst-address") {
-                                                dst_address = value;
-                                            } else if (prop_name == "src_port" || prop_name == "src-port") {
-                                                src_port = value;
-                                            } else if (prop_name == "dst_port" || prop_name == "dst-port") {
-                                                dst_port = value;
-                                            } else if (prop_name == "in_interface" || prop_name == "in-interface") {
-                                                in_interface = value;
-                                            } else if (prop_name == "out_interface" || prop_name == "out-interface") {
-                                                out_interface = value;
-                                            } else if (prop_name == "comment") {
-                                                comment = value;
-                                            }
-                                        }
-                                    }
-                                }
-                                
-                                // Generate the filter rule if an action is specified
-                                if (!action.empty()) {
-                                    result += "/ip firewall filter add chain=" + chain + " action=" + action;
+    // Process each subsection (filter, nat, etc.)
+    visit_statements(get_block(), overloaded{
+        [&](const SectionStatement& section) {
+            Symbol section_symbol = section.get_symbol();
+            
+            // Process filter rules
+            if (section_symbol == Symbol::FILTER) {
+                visit_statements(section.get_block(), overloaded{
+                    [&](const SectionStatement& rule) {
+                        std::string rule_name(rule.get_name());
+                        std::string chain = "forward"; // Default chain
+                        std::string action = "";
+                        std::string connection_state = "";
+                        std::string protocol = "";
+                        std::string src_address = "";
+                        std::string dst_address = "";
+                        std::string src_port = "";
+                        std::string dst_port = "";
+                        std::string in_interface = "";
+                        std::string out_interface = "";
+                        std::string comment = rule_name;
+                        
+                        // Look up the properties of this filter rule
+                        if (const BlockStatement* rule_block = rule.get_block()) {
+                            read_property(rule_block, action, Symbol::ACTION);
+                            if (action.empty()) {
+                                return;
+                            }
+                            
+                            read_property(rule_block, chain, Symbol::CHAIN);
+                            std::string value;
+                            if (read_property(rule_block, value, Symbol::CONNECTION_STATE, Symbol::CONNECTION_STATE_DASHED)) {
+                                // Handle array of states like ["established", "related"]
+                                if (value.front() == '[' && value.back() == ']') {
+                                    value = value.substr(1, value.size() - 2);
+                                    std::string state;
+                                    std::stringstream ss(value);
+                                    bool first = true;
                                     
-                                    // Add optional parameters
-                                    if (!connection_state.empty()) {
-                                        // Clean up connection_state - remove quotes and braces
-                                        std::string clean_conn_state;
-                                        bool in_quote = false;
+                                    while (ss >> state) {
+                                        // Clean up state - remove quotes and commas
+                                        state.erase(remove(state.begin(), state.end(), '"'), state.end());
+                                        state.erase(remove(state.begin(), state.end(), ','), state.end());
                                         
-                                        for (size_t i = 0; i < connection_state.size(); i++) {
-                                            char c = connection_state[i];
-                                            // Skip braces, quotes, and spaces
-                                            if (c == '{' || c == '}' || c == '"' || (c == ' ' && !in_quote)) {
-                                                continue;
+                                        if (!state.empty()) {
+                                            if (first) {
+                                                connection_state = state;
+                                                first = false;
+                                            } else {
+                                                connection_state += "," + state;
                                             }
-                                            clean_conn_state += c;
                                         }
-                                        
-                                        result += " connection-state=" + clean_conn_state;
-                                    }
-                                    if (!protocol.empty()) {
-                                        result += " protocol=" + protocol;
-                                    }
-                                    if (!src_address.empty()) {
-                                        result += " src-address=" + src_address;
-                                    }
-                                    if (!dst_address.empty()) {
-                                        result += " dst-address=" + dst_address;
-                                    }
-                                    if (!src_port.empty()) {
-                                        result += " src-port=" + src_port;
-                                    }
-                                    if (!dst_port.empty()) {
-                                        result += " dst-port=" + dst_port;
                                     }
-                                    if (!in_interface.empty()) {
-                                        result += " in-interface=" + in_interface;
-                                    }
-                                    if (!out_interface.empty()) {
-                                        result += " out-interface=" + out_interface;
-                                    }
-                                    if (!comment.empty()) {
-                                        result += " comment=\"" + comment + "\"";
-                                    }
-                                    
-                                    result += "\n";
+                                } else {
+                                    connection_state = value;
                                 }
                             }
+                            read_property(rule_block, protocol, Symbol::PROTOCOL);
+                            read_property(rule_block, src_address, Symbol::SRC_ADDRESS, Symbol::SRC_ADDRESS_DASHED);
+                            read_property(rule_block, dst_address, Symbol::DST_ADDRESS, Symbol::DST_ADDRESS_DASHED);
+                            read_property(rule_block, src_port, Symbol::SRC_PORT, Symbol::SRC_PORT_DASHED);
+                            read_property(rule_block, dst_port, Symbol::DST_PORT, Symbol::DST_PORT_DASHED);
+                            read_property(rule_block, in_interface, Symbol::IN_INTERFACE, Symbol::IN_INTERFACE_DASHED);
+                            read_property(rule_block, out_interface, Symbol::OUT_INTERFACE, Symbol::OUT_INTERFACE_DASHED);
+                            read_property(rule_block, comment, Symbol::COMMENT);
                         }
-                    }
-                }
-                // Process NAT rules
-                else if (section_name == "nat") {
-                    if (section->get_block()) {
-                        for (const auto* rule_stmt : section->get_block()->get_statements()) {
-                            if (const auto* rule = dynamic_cast<const SectionStatement*>(rule_stmt)) {
-                                std::string rule_name = rule->get_name();
-                                std::string chain = "srcnat"; // Default chain
-                                std::string action = "";
-                                std::string protocol = "";
-                                std::string src_address = "";
-                                std::string dst_address = "";
-                                std::string src_port = "";
-                                std::string dst_port = "";
-                                std::string in_interface = "";
-                                std::string out_interface = "";
-                                std::string to_addresses = "";
-                                std::string to_ports = "";
-                                std::string comment = rule_name;
+                        
+                        // Generate the filter rule if an action is specified
+                        if (!action.empty()) {
+                            result += "/ip firewall filter add chain=" + chain + " action=" + action;
+                            
+                            // Add optional parameters
+                            if (!connection_state.empty()) {
+                                // Clean up connection_state - remove quotes and braces
+                                std::string clean_conn_state;
+                                bool in_quote = false;
                                 
-                                // Extract properties for this NAT rule
-                                if (rule->get_block()) {
-                                    for (const auto* prop_stmt : rule->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(prop_stmt)) {
-                                            std::string prop_name = prop->get_name();
-                                            std::string value = "";
-                                            
-                                            if (prop->get_value()) {
-                                                value = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                }
-                                            }
-                                            
-                                            if (prop_name == "chain") {
-                                                chain = value;
-                                            } else if (prop_name == "action") {
-                                                action = value;
-                                            } else if (prop_name == "protocol") {
-                                                protocol = value;
-                                            } else if (prop_name == "src_address" || prop_name == "src-address") {
-                                                src_address = value;
-                                            } else if (prop_name == "dst_address" || prop_name == "dst-address") {
-                                                dst_address = value;
-                                            } else if (prop_name == "src_port" || prop_name == "src-port") {
-                                                src_port = value;
-                                            } else if (prop_name == "dst_port" || prop_name == "dst-port") {
-                                                dst_port = value;
-                                            } else if (prop_name == "in_interface" || prop_name == "in-interface") {
-                                                in_interface = value;
-                                            } else if (prop_name == "out_interface" || prop_name == "out-interface") {
-                                                out_interface = value;
-                                            } else if (prop_name == "to_addresses" || prop_name == "to-addresses") {
-                                                to_addresses = value;
-                                            } else if (prop_name == "to_ports" || prop_name == "to-ports") {
-                                                to_ports = value;
-                                            } else if (prop_name == "comment") {
-                                                comment = value;
-                                            }
-                                        }
+                                for (size_t i = 0; i < connection_state.size(); i++) {
+                                    char c = connection_state[i];
+                                    // Skip braces, quotes, and spaces
+                                    if (c == '{' || c == '}' || c == '"' || (c == ' ' && !in_quote)) {
+                                        continue;
                                     }
+                                    clean_conn_state += c;
                                 }
                                 
-                                // Generate the NAT rule if an action is specified
-                                if (!action.empty()) {
-                                    result += "/ip firewall nat add chain=" + chain + " action=" + action;
-                                    
-                                    // Add optional parameters
-                                    if (!protocol.empty()) {
-                                        result += " protocol=" + protocol;
-                                    }
-                                    if (!src_address.empty()) {
-                                        result += " src-address=" + src_address;
-                                    }
-                                    if (!dst_address.empty()) {
-                                        result += " dst-address=" + dst_address;
-                                    }
-                                    if (!src_port.empty()) {
-                                        result += " src-port=" + src_port;
-                                    }
-                                    if (!dst_port.empty()) {
-                                        result += " dst-port=" + dst_port;
-                                    }
-                                    if (!in_interface.empty()) {
-                                        result += " in-interface=" + in_interface;
-                                    }
-                                    if (!out_interface.empty()) {
-                                        result += " out-interface=" + out_interface;
-                                    }
-                                    if (!to_addresses.empty() && action != "masquerade") {
-                                        result += " to-addresses=" + to_addresses;
-                                    }
-                                    if (!to_ports.empty()) {
-                                        result += " to-ports=" + to_ports;
-                                    }
-                                    if (!comment.empty()) {
-                                        result += " comment=\"" + comment + "\"";
-                                    }
-                                    
-                                    result += "\n";
-                                }
+                                result += " connection-state=" + clean_conn_state;
+                            }
+                            if (!protocol.empty()) {
+                                result += " protocol=" + protocol;
+                            }
+                            if (!src_address.empty()) {
+                                result += " src-address=" + src_address;
+                            }
+                            if (!dst_address.empty()) {
+                                result += " dst-address=" + dst_address;
+                            }
+                            if (!src_port.empty()) {
+                                result += " src-port=" + src_port;
+                            }
+                            if (!dst_port.empty()) {
+                                result += " dst-port=" + dst_port;
+                            }
+                            if (!in_interface.empty()) {
+                                result += " in-interface=" + in_interface;
                             }
+                            if (!out_interface.empty()) {
+                                result += " out-interface=" + out_interface;
+                            }
+                            if (!comment.empty()) {
+                                result += " comment=\"" + comment + "\"";
+                            }
+                            
+                            result += "\n";
                         }
-                    }
-                }
-                // Process address-list rules (for blocking lists, etc.)
-                else if (section_name == "address-list") {
-                    if (section->get_block()) {
-                        for (const auto* list_stmt : section->get_block()->get_statements()) {
-                            if (const auto* list = dynamic_cast<const SectionStatement*>(list_stmt)) {
-                                std::string list_name = list->get_name();
-                                
-                                // Process each address in the list
-                                if (list->get_block()) {
-                                    for (const auto* addr_stmt : list->get_block()->get_statements()) {
-                                        if (const auto* addr_prop = dynamic_cast<const PropertyStatement*>(addr_stmt)) {
-                                            std::string address = addr_prop->get_name();
-                                            std::string comment = "";
-                                            std::string timeout = "";
-                                            
-                                            if (addr_prop->get_value()) {
-                                                // Check if it's a simple string (comment) or a block with properties
-                                                std::string value = addr_prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                    comment = value;
-                                                }
-                                            }
-                                            
-                                            // Generate address-list entry
-                                            result += "/ip firewall address-list add list=" + list_name;
-                                            result += " address=" + address;
-                                            if (!comment.empty()) {
-                                                result += " comment=\"" + comment + "\"";
-                                            }
-                                            if (!timeout.empty()) {
-                                                result += " timeout=" + timeout;
-                                            }
-                                            result += "\n";
-                                        }
-                                    }
-                                }
+                    },
+                    ignore_node{}});
+            }
+            // Process NAT rules
+            else if (section_symbol == Symbol::NAT) {
+                visit_statements(section.get_block(), overloaded{
+                    [&](const SectionStatement& rule) {
+                        std::string rule_name(rule.get_name());
+                        std::string chain = "srcnat"; // Default chain
+                        std::string action = "";
+                        std::string protocol = "";
+                        std::string src_address = "";
+                        std::string dst_address = "";
+                        std::string src_port = "";
+                        std::string dst_port = "";
+                        std::string in_interface = "";
+                        std::string out_interface = "";
+                        std::string to_addresses = "";
+                        std::string to_ports = "";
+                        std::string comment = rule_name;
+                        
+                        // Look up the properties of this NAT rule
+                        if (const BlockStatement* rule_block = rule.get_block()) {
+                            read_property(rule_block, action, Symbol::ACTION);
+                            if (action.empty()) {
+                                return;
                             }
+                            
+                            read_property(rule_block, chain, Symbol::CHAIN);
+                            read_property(rule_block, protocol, Symbol::PROTOCOL);
+                            read_property(rule_block, src_address, Symbol::SRC_ADDRESS, Symbol::SRC_ADDRESS_DASHED);
+                            read_property(rule_block, dst_address, Symbol::DST_ADDRESS, Symbol::DST_ADDRESS_DASHED);
+                            read_property(rule_block, src_port, Symbol::SRC_PORT, Symbol::SRC_PORT_DASHED);
+                            read_property(rule_block, dst_port, Symbol::DST_PORT, Symbol::DST_PORT_DASHED);
+                            read_property(rule_block, in_interface, Symbol::IN_INTERFACE, Symbol::IN_INTERFACE_DASHED);
+                            read_property(rule_block, out_interface, Symbol::OUT_INTERFACE, Symbol::OUT_INTERFACE_DASHED);
+                            read_property(rule_block, to_addresses, Symbol::TO_ADDRESSES, Symbol::TO_ADDRESSES_DASHED);
+                            read_property(rule_block, to_ports, Symbol::TO_PORTS, Symbol::TO_PORTS_DASHED);
+                            read_property(rule_block, comment, Symbol::COMMENT);
                         }
-                    }
-                }
-                // Process service-port rules
-                else if (section_name == "service-port") {
-                    if (section->get_block()) {
-                        for (const auto* service_stmt : section->get_block()->get_statements()) {
-                            if (const auto* service_prop = dynamic_cast<const PropertyStatement*>(service_stmt)) {
-                                std::string service_name = service_prop->get_name();
-                                std::string value = "";
-                                
-                                if (service_prop->get_value()) {
-                                    value = service_prop->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                        value = value.substr(1, value.size() - 2);
-                                    }
-                                }
-                                
-                                // Generate service-port setting
-                                if (value == "yes" || value == "true") {
-                                    result += "/ip firewall service-port set " + service_name + " disabled=no\n";
-                                } else if (value == "no" || value == "false") {
-                                    result += "/ip firewall service-port set " + service_name + " disabled=yes\n";
-                                }
+                        
+                        // Generate the NAT rule if an action is specified
+                        if (!action.empty()) {
+                            result += "/ip firewall nat add chain=" + chain + " action=" + action;
+                            
+                            // Add optional parameters
+                            if (!protocol.empty()) {
+                                result += " protocol=" + protocol;
                             }
+                            if (!src_address.empty()) {
+                                result += " src-address=" + src_address;
+                            }
+                            if (!dst_address.empty()) {
+                                result += " dst-address=" + dst_address;
+                            }
+                            if (!src_port.empty()) {
+                                result += " src-port=" + src_port;
+                            }
+                            if (!dst_port.empty()) {
+                                result += " dst-port=" + dst_port;
+                            }
+                            if (!in_interface.empty()) {
+                                result += " in-interface=" + in_interface;
+                            }
+                            if (!out_interface.empty()) {
+                                result += " out-interface=" + out_interface;
+                            }
+                            if (!to_addresses.empty() && action != "masquerade") {
+                                result += " to-addresses=" + to_addresses;
+                            }
+                            if (!to_ports.empty()) {
+                                result += " to-ports=" + to_ports;
+                            }
+                            if (!comment.empty()) {
+                                result += " comment=\"" + comment + "\"";
+                            }
+                            
+                            result += "\n";
                         }
-                    }
-                }
-                // Process raw rules (advanced firewall)
-                else if (section_name == "raw") {
-                    if (section->get_block()) {
-                        for (const auto* rule_stmt : section->get_block()->get_statements()) {
-                            if (const auto* rule = dynamic_cast<const SectionStatement*>(rule_stmt)) {
-                                std::string rule_name = rule->get_name();
-                                std::string chain = "prerouting"; // Default chain
-                                std::string action = "";
-                                std::string protocol = "";
-                                std::string src_address = "";
-                                std::string dst_address = "";
-                                std::string comment = rule_name;
+                    },
+                    ignore_node{}});
+            }
+            // Process address-list rules (for blocking lists, etc.)
+            else if (section_symbol == Symbol::ADDRESS_LIST_DASHED) {
+                visit_statements(section.get_block(), overloaded{
+                    [&](const SectionStatement& list) {
+                        std::string list_name(list.get_name());
+                        
+                        // Process each address in the list
+                        visit_statements(list.get_block(), overloaded{
+                            [&](const PropertyStatement& addr_prop) {
+                                std::string address(addr_prop.get_name());
+                                std::string comment = "";
+                                std::string timeout = "";
                                 
-                                // Extract properties for this raw rule
-                                if (rule->get_block()) {
-                                    for (const auto* prop_stmt : rule->get_block()->get_statements()) {
-                                        if (const auto* prop = dynamic_cast<const PropertyStatement*>(prop_stmt)) {
-                                            std::string prop_name = prop->get_name();
-                                            std::string value = "";
-                                            
-                                            if (prop->get_value()) {
-                                                value = prop->get_value()->to_mikrotik("");
-                                                // Remove quotes if present
-                                                if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
-                                                    value = value.substr(1, value.size() - 2);
-                                                }
-                                            }
-                                            
-                                            if (prop_name == "chain") {
-                                                chain = value;
-                                            } else if (prop_name == "action") {
-                                                action = value;
-                                            } else if (prop_name == "protocol") {
-                                                protocol = value;
-                                            } else if (prop_name == "src_address" || prop_name == "src-address") {
-                                                src_address = value;
-                                            } else if (prop_name == "dst_address" || prop_name == "dst-address") {
-                                                dst_address = value;
-                                            } else if (prop_name == "comment") {
-                                                comment = value;
-                                            }
-                                        }
-                                    }
+                                // A string literal is the comment of the entry
+                                const auto* text = node_cast<StringValue>(addr_prop.get_value());
+                                if (text && text->is_quoted()) {
+                                    comment = text->get_value();
                                 }
                                 
-                                // Generate the raw rule if an action is specified
-                                if (!action.empty()) {
-                                    result += "/ip firewall raw add chain=" + chain + " action=" + action;
-                                    
-                                    // Add optional parameters
-                                    if (!protocol.empty()) {
-                                        result += " protocol=" + protocol;
-                                    }
-                                    if (!src_address.empty()) {
-                                        result += " src-address=" + src_address;
-                                    }
-                                    if (!dst_address.empty()) {
-                                        result += " dst-address=" + dst_address;
-                                    }
-                                    if (!comment.empty()) {
-                                        result += " comment=\"" + comment + "\"";
-                                    }
-                                    
-                                    result += "\n";
+                                // Generate address-list entry
+                                result += "/ip firewall address-list add list=" + list_name;
+                                result += " address=" + address;
+                                if (!comment.empty()) {
+                                    result += " comment=\"" + comment + "\"";
                                 }
+                                if (!timeout.empty()) {
+                                    result += " timeout=" + timeout;
+                                }
+                                result += "\n";
+                            },
+                            ignore_node{}});
+                    },
+                    ignore_node{}});
+            }
+            // Process service-port rules
+            else if (section_symbol == Symbol::SERVICE_PORT_DASHED) {
+                visit_statements(section.get_block(), overloaded{
+                    [&](const PropertyStatement& service_prop) {
+                        std::string service_name(service_prop.get_name());
+                        std::string storage;
+                        std::string_view value;
+                        
+                        if (service_prop.get_value()) {
+                            value = value_text(service_prop.get_value(), storage);
+                        }
+                        
+                        // Generate service-port setting
+                        if (value == "yes" || value == "true") {
+                            result += "/ip firewall service-port set " + service_name + " disabled=no\n";
+                        } else if (value == "no" || value == "false") {
+                            result += "/ip firewall service-port set " + service_name + " disabled=yes\n";
+                        }
+                    },
+                    ignore_node{}});
+            }
+            // Process raw rules (advanced firewall)
+            else if (section_symbol == Symbol::RAW) {
+                visit_statements(section.get_block(), overloaded{
+                    [&](const SectionStatement& rule) {
+                        std::string rule_name(rule.get_name());
+                        std::string chain = "prerouting"; // Default chain
+                        std::string action = "";
+                        std::string protocol = "";
+                        std::string src_address = "";
+                        std::string dst_address = "";
+                        std::string comment = rule_name;
+                        
+                        // Look up the properties of this raw rule
+                        if (const BlockStatement* rule_block = rule.get_block()) {
+                            read_property(rule_block, action, Symbol::ACTION);
+                            if (action.empty()) {
+                                return;
                             }
+                            
+                            read_property(rule_block, chain, Symbol::CHAIN);
+                            read_property(rule_block, protocol, Symbol::PROTOCOL);
+                            read_property(rule_block, src_address, Symbol::SRC_ADDRESS, Symbol::SRC_ADDRESS_DASHED);
+                            read_property(rule_block, dst_address, Symbol::DST_ADDRESS, Symbol::DST_ADDRESS_DASHED);
+                            read_property(rule_block, comment, Symbol::COMMENT);
                         }
-                    }
-                }
+                        
+                        // Generate the raw rule if an action is specified
+                        if (!action.empty()) {
+                            result += "/ip firewall raw add chain=" + chain + " action=" + action;
+                            
+                            // Add optional parameters
+                            if (!protocol.empty()) {
+                                result += " protocol=" + protocol;
+                            }
+                            if (!src_address.empty()) {
+                                result += " src-address=" + src_address;
+                            }
+                            if (!dst_address.empty()) {
+                                result += " dst-address=" + dst_address;
+                            }
+                            if (!comment.empty()) {
+                                result += " comment=\"" + comment + "\"";
+                            }
+                            
+                            result += "\n";
+                        }
+                    },
+                    ignore_node{}});
             }
-        }
-    }
+        },
+        ignore_node{}});
     
     return result;
 }
 
 // SystemSection implementation
 SystemSection::SystemSection(std::string_view name) noexcept
-    : DeviceSection(name)
+    : DeviceSection(NodeKind::SYSTEM_SECTION, name)
 {
     this->type = SectionType::SYSTEM;
 }
 
 // CustomSection implementation
 CustomSection::CustomSection(std::string_view name) noexcept
-    : SpecializedSection(name)
+    : SpecializedSection(NodeKind::CUSTOM_SECTION, name)
 {
     this->type = SectionType::CUSTOM;
 }
 
-std::tuple<bool, std::string> CustomSection::validate() const noexcept {
+std::tuple<bool, std::string> CustomSection::validate(SourceSpan& error_span) const noexcept {
     const BlockStatement* block = get_block();
+    error_span = get_span();
     if (!block) return {false, "Custom section is missing a block statement"};
     
     // Custom sections are more permissive
@@ -1376,7 +1159,8 @@ std::tuple<bool, std::string> CustomSection::validate() const noexcept {
 }
 
 std::string CustomSection::translate_section(const std::string& ident) const {
-    std::string result = ident + "# Custom Configuration: " + get_name() + "\n";
+    // Nested custom sections are named by their path
+    std::string result = ident + "# Custom Configuration: " + std::string(get_path()) + "\n";
     
     if (get_block()) {
         // For custom sections, simply translate the block
@@ -1387,22 +1171,50 @@ std::string CustomSection::translate_section(const std::string& ident) const {
 }
 
 // Factory function implementation
-SpecializedSection* create_specialized_section(std::string_view name, SectionStatement::SectionType type) {
+SpecializedSection* create_specialized_section(AstArena& arena, std::string_view name, SectionStatement::SectionType type) {
     switch (type) {
         case SectionStatement::SectionType::DEVICE:
-            return new DeviceSection(name);
+            return arena.make<DeviceSection>(name);
         case SectionStatement::SectionType::INTERFACES:
-            return new InterfacesSection(name);
+            return arena.make<InterfacesSection>(name);
         case SectionStatement::SectionType::IP:
-            return new IPSection(name);
+            return arena.make<IPSection>(name);
         case SectionStatement::SectionType::ROUTING:
-            return new RoutingSection(name);
+            return arena.make<RoutingSection>(name);
         case SectionStatement::SectionType::FIREWALL:
-            return new FirewallSection(name);
+            return arena.make<FirewallSection>(name);
         case SectionStatement::SectionType::SYSTEM:
-            return new SystemSection(name);
+            return arena.make<SystemSection>(name);
         case SectionStatement::SectionType::CUSTOM:
         default:
-            return new CustomSection(name);
+            return arena.make<CustomSection>(name);
+    }
+} 
+
+bool check_section(const SectionStatement* section, SourceSpan& error_span, std::string& error) {
+    const SpecializedSection* specialized = node_cast<SpecializedSection>(section);
+    if (!specialized) {
+        return true;
+    }
+    error_span = specialized->get_span();
+    auto [is_valid, error_message] = specialized->validate(error_span);
+    if (!is_valid) {
+        error = std::move(error_message);
     }
-} 
\ No newline at end of file
+    return is_valid;
+}
+
+std::string format_section_error(std::string_view section_name, SourcePosition position, const std::string& error) {
+    return "Error in section '" + std::string(section_name) + "' at line " + std::to_string(position.line) +
+           ", column " + std::to_string(position.column) + ": " + error;
+}
+
+bool validate_section(const SectionStatement* section, const LineIndex& line_index, std::string& message) {
+    SourceSpan error_span;
+    std::string error;
+    if (check_section(section, error_span, error)) {
+        return true;
+    }
+    message = format_section_error(section->get_name(), line_index.position(error_span.offset), error);
+    return false;
+}
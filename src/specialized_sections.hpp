@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ast_arena.hpp"
 #include "statement.hpp"
 #include <map>
 #include <tuple>
@@ -7,10 +8,16 @@
 // Base class for all specialized sections
 class SpecializedSection : public SectionStatement {
 public:
-    SpecializedSection(std::string_view name) noexcept;
+    SpecializedSection(NodeKind kind, std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::DEVICE_SECTION, NodeKind::CUSTOM_SECTION);
+    }
     
-    // Add semantic validation method with error message
-    virtual std::tuple<bool, std::string> validate() const noexcept = 0;
+    // Add semantic validation method with error message; on failure
+    // error_span is set to the location the error is about
+    virtual std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept = 0;
     
     // Override the to_mikrotik method for specialized translation
     std::string to_mikrotik(const std::string& ident) const override;
@@ -24,10 +31,21 @@ protected:
 class DeviceSection : public SpecializedSection {
 public:
     DeviceSection(std::string_view name) noexcept;
+
+    // System sections are device sections too
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind == NodeKind::DEVICE_SECTION || kind == NodeKind::SYSTEM_SECTION;
+    }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
+
+    // The hostname property without its quotes, "" if there is none
+    std::string get_hostname() const;
     
 protected:
+    DeviceSection(NodeKind kind, std::string_view name) noexcept;
+
     std::string translate_section(const std::string& ident) const override;
 };
 
@@ -35,8 +53,10 @@ protected:
 class InterfacesSection : public SpecializedSection {
 public:
     InterfacesSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::INTERFACES_SECTION; }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
     
 protected:
     std::string translate_section(const std::string& ident) const override;
@@ -50,8 +70,10 @@ private:
 class IPSection : public SpecializedSection {
 public:
     IPSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::IP_SECTION; }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
     
 protected:
     std::string translate_section(const std::string& ident) const override;
@@ -61,8 +83,10 @@ protected:
 class RoutingSection : public SpecializedSection {
 public:
     RoutingSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::ROUTING_SECTION; }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
     
 protected:
     std::string translate_section(const std::string& ident) const override;
@@ -72,8 +96,10 @@ protected:
 class FirewallSection : public SpecializedSection {
 public:
     FirewallSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::FIREWALL_SECTION; }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
     
 protected:
     std::string translate_section(const std::string& ident) const override;
@@ -83,18 +109,32 @@ protected:
 class SystemSection : public DeviceSection {
 public:
     SystemSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::SYSTEM_SECTION; }
 };
 
 // Custom section
 class CustomSection : public SpecializedSection {
 public:
     CustomSection(std::string_view name) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::CUSTOM_SECTION; }
     
-    std::tuple<bool, std::string> validate() const noexcept override;
+    std::tuple<bool, std::string> validate(SourceSpan& error_span) const noexcept override;
     
 protected:
     std::string translate_section(const std::string& ident) const override;
 };
 
-// Factory function to create the appropriate specialized section
-SpecializedSection* create_specialized_section(std::string_view name, SectionStatement::SectionType type); 
\ No newline at end of file
+// Factory function to create the appropriate specialized section in the arena
+SpecializedSection* create_specialized_section(AstArena& arena, std::string_view name, SectionStatement::SectionType type); 
+
+// Validates a top-level section (only specialized sections have rules). On
+// failure error says what is wrong and error_span which node it is about.
+bool check_section(const SectionStatement* section, SourceSpan& error_span, std::string& error);
+
+// Validation error as reported to the user
+std::string format_section_error(std::string_view section_name, SourcePosition position, const std::string& error);
+
+// check_section with the error formatted, located through line_index
+bool validate_section(const SectionStatement* section, const LineIndex& line_index, std::string& message);
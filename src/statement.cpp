@@ -3,27 +3,25 @@
 #include <sstream>
 #include <algorithm>
 
+Statement::Statement(NodeKind kind) noexcept : ASTNodeInterface(kind) {}
+
 // PropertyStatement implementation
-PropertyStatement::PropertyStatement(std::string_view name, Expression* value) noexcept 
-    : name(name), value(value) {}
+PropertyStatement::PropertyStatement(std::string_view name, Expression* value, Symbol symbol) noexcept 
+    : Statement(NodeKind::PROPERTY_STATEMENT), name(name), value(value), symbol(symbol) {}
 
-const std::string& PropertyStatement::get_name() const noexcept 
+std::string_view PropertyStatement::get_name() const noexcept 
 {
     return name;
 }
 
-Expression* PropertyStatement::get_value() const noexcept 
+Symbol PropertyStatement::get_symbol() const noexcept
 {
-    return value;
+    return symbol;
 }
 
-void PropertyStatement::destroy() noexcept 
+Expression* PropertyStatement::get_value() const noexcept 
 {
-    if (value) {
-        value->destroy();
-        delete value;
-        value = nullptr;
-    }
+    return value;
 }
 
 std::string PropertyStatement::to_string() const 
@@ -63,22 +61,58 @@ std::string PropertyStatement::to_mikrotik(const std::string& ident) const
 }
 
 // BlockStatement implementation
-BlockStatement::BlockStatement() noexcept : statements() {}
-
-BlockStatement::BlockStatement(const StatementList& statements) noexcept 
-    : statements(statements) {}
+BlockStatement::BlockStatement(std::pmr::memory_resource* resource) noexcept 
+    : Statement(NodeKind::BLOCK_STATEMENT), statements(resource) {}
 
 void BlockStatement::add_statement(Statement* statement) noexcept 
 {
     if (statement) {
        
         statements.push_back(statement);
-        
-        // If this statement is a section, look for its parent in the surrounding blocks
-        if (dynamic_cast<SectionStatement*>(statement)) {
-            // Find the parent section by walking up the AST
-            // We can only do this if we have a parent/owner tracking mechanism
-            // For now, this will be handled by the ProgramDeclaration::add_section method
+        indexed = false;
+    }
+}
+
+void BlockStatement::index_properties()
+{
+    known_assigned.fill(0);
+    known_count = 0;
+    property_count = 0;
+    indexed = true;
+
+    // Which known symbols are assigned gives where each entry goes
+    size_t interned = 0;
+    for (const Statement* statement : statements) {
+        if (const auto* property = node_cast<PropertyStatement>(statement)) {
+            auto bit = static_cast<size_t>(property->get_symbol());
+            if (property->get_symbol() < Symbol::FIRST_INTERNED) {
+                known_assigned[bit / 64] |= uint64_t{1} << (bit % 64);
+            } else {
+                ++interned;
+            }
+        }
+    }
+    for (uint64_t word : known_assigned) {
+        known_count += __builtin_popcountll(word);
+    }
+    if (known_count + interned == 0) {
+        return;
+    }
+
+    // Later assignments overwrite the entry of an earlier one. The entries
+    // are freed with the arena, as the statements are.
+    void* memory = statements.get_allocator().resource()->allocate((known_count + interned) * sizeof(PropertyEntry),
+                                                                    alignof(PropertyEntry));
+    property_index = static_cast<PropertyEntry*>(memory);
+    property_count = known_count;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        if (const auto* property = node_cast<PropertyStatement>(statements[i])) {
+            PropertyEntry entry{property->get_symbol(), static_cast<uint32_t>(i), property};
+            if (entry.symbol < Symbol::FIRST_INTERNED) {
+                property_index[known_rank(entry.symbol)] = entry;
+            } else {
+                property_index[property_count++] = entry;
+            }
         }
     }
 }
@@ -88,15 +122,75 @@ const StatementList& BlockStatement::get_statements() const noexcept
     return statements;
 }
 
-void BlockStatement::destroy() noexcept 
+size_t BlockStatement::known_rank(Symbol symbol) const noexcept
 {
-    for (auto* statement : statements) {
-        if (statement) {
-            statement->destroy();
-            delete statement;
+    // Entries of the known symbols assigned below this one
+    auto bit = static_cast<size_t>(symbol);
+    size_t rank = __builtin_popcountll(known_assigned[bit / 64] & ((uint64_t{1} << (bit % 64)) - 1));
+    for (size_t w = 0; w < bit / 64; ++w) {
+        rank += __builtin_popcountll(known_assigned[w]);
+    }
+    return rank;
+}
+
+const BlockStatement::PropertyEntry* BlockStatement::find_entry(Symbol symbol) const noexcept
+{
+    if (symbol < Symbol::FIRST_INTERNED) {
+        auto bit = static_cast<size_t>(symbol);
+        bool assigned = known_assigned[bit / 64] >> (bit % 64) & 1;
+        return assigned ? &property_index[known_rank(symbol)] : nullptr;
+    }
+
+    // Interned names: the last assignment wins
+    for (size_t i = property_count; i-- > known_count;) {
+        if (property_index[i].symbol == symbol) {
+            return &property_index[i];
         }
     }
-    statements.clear();
+    return nullptr;
+}
+
+const PropertyStatement* BlockStatement::find_property(Symbol symbol) const noexcept
+{
+    return find_property(symbol, symbol);
+}
+
+const PropertyStatement* BlockStatement::find_property(Symbol symbol, Symbol alias) const noexcept
+{
+    if (!indexed) {
+        for (auto it = statements.rbegin(); it != statements.rend(); ++it) {
+            const auto* property = node_cast<PropertyStatement>(*it);
+            if (property && (property->get_symbol() == symbol || property->get_symbol() == alias)) {
+                return property;
+            }
+        }
+        return nullptr;
+    }
+
+    const PropertyEntry* entry = find_entry(symbol);
+    const PropertyEntry* alias_entry = alias == symbol ? nullptr : find_entry(alias);
+    if (alias_entry && (!entry || alias_entry->position > entry->position)) {
+        entry = alias_entry;
+    }
+    return entry ? entry->property : nullptr;
+}
+
+std::optional<std::string_view> BlockStatement::get_string(Symbol symbol) const noexcept
+{
+    const PropertyStatement* property = find_property(symbol);
+    if (const auto* value = property ? node_cast<StringValue>(property->get_value()) : nullptr) {
+        return value->get_value();
+    }
+    return std::nullopt;
+}
+
+std::optional<int> BlockStatement::get_int(Symbol symbol) const noexcept
+{
+    const PropertyStatement* property = find_property(symbol);
+    if (const auto* value = property ? node_cast<NumberValue>(property->get_value()) : nullptr) {
+        return value->get_value();
+    }
+    return std::nullopt;
 }
 
 std::string BlockStatement::to_string() const 
@@ -126,16 +220,29 @@ std::string BlockStatement::to_mikrotik(const std::string& ident) const
 
 // SectionStatement implementation
 SectionStatement::SectionStatement(std::string_view name, SectionType type) noexcept 
-    : name(name), type(type), block(nullptr), parent_section(nullptr) {}
+    : SectionStatement(NodeKind::SECTION_STATEMENT, name, type) {}
 
 SectionStatement::SectionStatement(std::string_view name, SectionType type, BlockStatement* block) noexcept 
-    : name(name), type(type), block(block), parent_section(nullptr) {}
+    : Statement(NodeKind::SECTION_STATEMENT), name(name), type(type), block(block), parent_section(nullptr) {}
+
+SectionStatement::SectionStatement(NodeKind kind, std::string_view name, SectionType type) noexcept
+    : Statement(kind), name(name), type(type), block(nullptr), parent_section(nullptr) {}
 
-const std::string& SectionStatement::get_name() const noexcept 
+std::string_view SectionStatement::get_name() const noexcept 
 {
     return name;
 }
 
+Symbol SectionStatement::get_symbol() const noexcept
+{
+    return symbol;
+}
+
+void SectionStatement::set_symbol(Symbol name_symbol) noexcept
+{
+    symbol = name_symbol;
+}
+
 SectionStatement::SectionType SectionStatement::get_section_type() const noexcept 
 {
     return type;
@@ -161,33 +268,54 @@ SectionStatement* SectionStatement::get_parent() const noexcept
     return parent_section;
 }
 
-SectionStatement::SectionType SectionStatement::get_effective_type() const noexcept 
+void SectionStatement::link_subsections(std::pmr::memory_resource* resource)
 {
-    // If this is a custom section and has a parent, determine its actual type based on context
-    if (type == SectionType::CUSTOM && parent_section != nullptr) {
-        SectionType parent_type = parent_section->get_section_type();
-        
-        // Handle subsections based on parent context
-        if (parent_type == SectionType::INTERFACES) {
-            // Inside interfaces section, treat subsections as interface definitions
-            return SectionType::INTERFACES;
-        }
-        else if (parent_type == SectionType::IP) {
-            // Inside IP section, treat subsections as IP configuration
-            return SectionType::IP;
-        }
-        else if (parent_type == SectionType::ROUTING) {
-            // Inside routing section
-            return SectionType::ROUTING;
-        }
-        else if (parent_type == SectionType::FIREWALL) {
-            // Inside firewall section
-            return SectionType::FIREWALL;
+    if (parent_section == nullptr) {
+        path = name;
+    }
+    if (block == nullptr) {
+        return;
+    }
+
+    SectionType inherited = get_effective_type();
+    bool inherits = inherited == SectionType::INTERFACES || inherited == SectionType::IP ||
+                    inherited == SectionType::ROUTING || inherited == SectionType::FIREWALL;
+    for (Statement* statement : block->get_statements()) {
+        auto* sub_section = node_cast<SectionStatement>(statement);
+        if (sub_section == nullptr) {
+            continue;
         }
+        sub_section->parent_section = this;
+        sub_section->depth = static_cast<uint16_t>(depth + 1);
+        sub_section->effective_type =
+            sub_section->type == SectionType::CUSTOM && inherits ? inherited : sub_section->type;
+
+        // "parent/name", freed with the arena as the sections are
+        size_t length = path.size() + 1 + sub_section->name.size();
+        char* text = static_cast<char*>(resource->allocate(length, 1));
+        path.copy(text, path.size());
+        text[path.size()] = '/';
+        sub_section->name.copy(text + path.size() + 1, sub_section->name.size());
+        sub_section->path = std::string_view(text, length);
+
+        sub_section->link_subsections(resource);
     }
-    
-    // Default to the original type
-    return type;
+}
+
+SectionStatement::SectionType SectionStatement::get_effective_type() const noexcept 
+{
+    // Top-level sections keep their own type
+    return parent_section != nullptr ? effective_type : type;
+}
+
+std::string_view SectionStatement::get_path() const noexcept
+{
+    return path.empty() ? name : path;
+}
+
+unsigned SectionStatement::get_depth() const noexcept
+{
+    return depth;
 }
 
 std::string SectionStatement::section_type_to_string(SectionType type) 
@@ -204,15 +332,6 @@ std::string SectionStatement::section_type_to_string(SectionType type)
     }
 }
 
-void SectionStatement::destroy() noexcept 
-{
-    if (block) {
-        block->destroy();
-        delete block;
-        block = nullptr;
-    }
-}
-
 std::string SectionStatement::to_string() const 
 {
     std::stringstream ss;
@@ -251,7 +370,7 @@ std::string SectionStatement::to_mikrotik(const std::string& ident) const
         case SectionType::CUSTOM:
         default:
             // For custom sections, use the name as the path
-            mikrotik_path = "/" + name;
+            mikrotik_path = "/" + std::string(name);
             // Convert spaces to dashes and make lowercase
             std::transform(mikrotik_path.begin(), mikrotik_path.end(), mikrotik_path.begin(), ::tolower);
             std::replace(mikrotik_path.begin(), mikrotik_path.end(), ' ', '-');
@@ -259,7 +378,7 @@ std::string SectionStatement::to_mikrotik(const std::string& ident) const
     }
 
     // Determine action based on section type and name
-    std::string action = determine_action(type, name);
+    std::string action = determine_action(type, std::string(name));
 
     // Special handling for device section which maps to /system identity
     if (type == SectionType::DEVICE) {
@@ -270,23 +389,17 @@ std::string SectionStatement::to_mikrotik(const std::string& ident) const
         // Extract vendor and model values from property statements
         if (block) {
             for (const auto* stmt : block->get_statements()) {
-                if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(stmt)) {
-                    const std::string& prop_name = prop_stmt->get_name();
-                    if (prop_name == "vendor") {
+                if (const auto* prop_stmt = node_cast<PropertyStatement>(stmt)) {
+                    Symbol prop_symbol = prop_stmt->get_symbol();
+                    if (prop_symbol == Symbol::VENDOR) {
                         if (prop_stmt->get_value()) {
-                            vendor_value = prop_stmt->get_value()->to_mikrotik("");
-                            // Remove quotes if present
-                            if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                                vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                            }
+                            std::string storage;
+                            vendor_value = value_text(prop_stmt->get_value(), storage);
                         }
-                    } else if (prop_name == "model") {
+                    } else if (prop_symbol == Symbol::MODEL) {
                         if (prop_stmt->get_value()) {
-                            model_value = prop_stmt->get_value()->to_mikrotik("");
-                            // Remove quotes if present
-                            if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                                model_value = model_value.substr(1, model_value.size() - 2);
-                            }
+                            std::string storage;
+                            model_value = value_text(prop_stmt->get_value(), storage);
                         }
                     } else {
                         // Process other statements - BUT NOT vendor or model separately
@@ -301,25 +414,10 @@ std::string SectionStatement::to_mikrotik(const std::string& ident) const
         if (!vendor_value.empty() || !model_value.empty()) {
             std::string device_name;
             if (!vendor_value.empty() && !model_value.empty()) {
-                // Remove quotes if present in both values
-                if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                    vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                }
-                if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                    model_value = model_value.substr(1, model_value.size() - 2);
-                }
                 device_name = vendor_value + "_" + model_value;
             } else if (!vendor_value.empty()) {
-                // Remove quotes if present
-                if (vendor_value.size() >= 2 && vendor_value.front() == '"' && vendor_value.back() == '"') {
-                    vendor_value = vendor_value.substr(1, vendor_value.size() - 2);
-                }
                 device_name = vendor_value;
             } else {
-                // Remove quotes if present
-                if (model_value.size() >= 2 && model_value.front() == '"' && model_value.back() == '"') {
-                    model_value = model_value.substr(1, model_value.size() - 2);
-                }
                 device_name = model_value;
             }
             
@@ -347,10 +445,10 @@ if (type == SectionType::INTERFACES) {
         if (block) {
             for (const auto* stmt : block->get_statements()) {
                 // Check if this is a subsection (like "ether1:")
-                if (const auto* sub_section = dynamic_cast<const SectionStatement*>(stmt)) {
+                if (const auto* sub_section = node_cast<SectionStatement>(stmt)) {
            
                     // Get the interface name (e.g., "ether1" from "ether1:")
-                    std::string interface_name = sub_section->get_name();
+                    std::string interface_name(sub_section->get_name());
                     
                  
                     // Remove trailing colon if present
@@ -373,35 +471,34 @@ if (type == SectionType::INTERFACES) {
                     // Process properties of this interface
                     if (sub_section->get_block()) {
                         for (const auto* sub_stmt : sub_section->get_block()->get_statements()) {
-                            if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(sub_stmt)) {
-                                const std::string& prop_name = prop_stmt->get_name();
-                                std::string prop_value;
+                            if (const auto* prop_stmt = node_cast<PropertyStatement>(sub_stmt)) {
+                                std::string_view prop_name = prop_stmt->get_name();
+                                Symbol prop_symbol = prop_stmt->get_symbol();
+                                std::string storage;
+                                std::string_view prop_value;
                                 
                                 // Extract the value carefully
                                 if (prop_stmt->get_value()) {
-                                    prop_value = prop_stmt->get_value()->to_mikrotik("");
-                                    // Remove quotes if present
-                                    if (prop_value.size() >= 2 && prop_value.front() == '"' && prop_value.back() == '"') {
-                                        prop_value = prop_value.substr(1, prop_value.size() - 2);
-                                    }
+                                    prop_value = value_text(prop_stmt->get_value(), storage);
                                 }
                                 
                                 // Handle specific properties
-                                if (prop_name == "type") {
+                                if (prop_symbol == Symbol::TYPE) {
                                     interface_type = prop_value;
                                 }
-                                else if (prop_name == "description") {
+                                else if (prop_symbol == Symbol::DESCRIPTION) {
                                     // Map description to comment
-                                    interface_properties.push_back("comment=\"" + prop_value + "\"");
+                                    interface_properties.push_back("comment=\"" + std::string(prop_value) + "\"");
                                 }
                                 else {
                                     // Add other properties as-is but with cleaned values
-                                    interface_properties.push_back(prop_name + "=\"" + prop_value + "\"");
+                                    interface_properties.push_back(std::string(prop_name) + "=\"" + std::string(prop_value) + "\"");
                                 }
                             }
-                            else if (const auto* nested_section = dynamic_cast<const SectionStatement*>(sub_stmt)) {
+                            else if (const auto* nested_section = node_cast<SectionStatement>(sub_stmt)) {
                                 // Process nested sections (like IP configuration)
-                                std::string nested_section_name = nested_section->get_name();
+                                std::string nested_section_name(nested_section->get_name());
+                                Symbol nested_symbol = nested_section->get_symbol();
                                 
                                 // Remove trailing colon if present in nested section name
                                 if (!nested_section_name.empty() && nested_section_name.back() == ':') {
@@ -409,17 +506,14 @@ if (type == SectionType::INTERFACES) {
                                 }
                                 
                                 // Handle specific nested sections
-                                if (nested_section_name == "ip") {
+                                if (nested_symbol == Symbol::IP) {
                                     // Process IP configuration for this interface
                                     if (nested_section->get_block()) {
                                         for (const auto* ip_stmt : nested_section->get_block()->get_statements()) {
-                                            if (const auto* ip_prop = dynamic_cast<const PropertyStatement*>(ip_stmt)) {
-                                                if (ip_prop->get_name() == "address" && ip_prop->get_value()) {
-                                                    std::string ip_value = ip_prop->get_value()->to_mikrotik("");
-                                                    // Remove quotes if present
-                                                    if (ip_value.size() >= 2 && ip_value.front() == '"' && ip_value.back() == '"') {
-                                                        ip_value = ip_value.substr(1, ip_value.size() - 2);
-                                                    }
+                                            if (const auto* ip_prop = node_cast<PropertyStatement>(ip_stmt)) {
+                                                if (ip_prop->get_symbol() == Symbol::ADDRESS && ip_prop->get_value()) {
+                                                    std::string storage;
+                                                    std::string_view ip_value = value_text(ip_prop->get_value(), storage);
                                                     
                                                     // Generate /ip address add command - use hardcoded path
                                                     sub_nested_commands << "/ip address add address=" 
@@ -496,12 +590,12 @@ if (type == SectionType::INTERFACES) {
 
     if (block) {
         for (const auto* stmt : block->get_statements()) {
-            if (const auto* prop_stmt = dynamic_cast<const PropertyStatement*>(stmt)) {
+            if (const auto* prop_stmt = node_cast<PropertyStatement>(stmt)) {
                 // Add the name=value pair without additional formatting
                 property_params.push_back(prop_stmt->to_mikrotik(""));
-            } else if (const auto* sub_section = dynamic_cast<const SectionStatement*>(stmt)) {
+            } else if (const auto* sub_section = node_cast<SectionStatement>(stmt)) {
                 // Handle sub-section: adjust the path for the nested section
-                std::string sub_name = sub_section->get_name();
+                std::string sub_name(sub_section->get_name());
                 
                 // Remove any trailing colon
                 if (!sub_name.empty() && sub_name.back() == ':') {
@@ -528,8 +622,9 @@ if (type == SectionType::INTERFACES) {
                 // Process the sub-section with the combined path
                 std::stringstream sub_section_ss;
                 
-                // Determine action for the sub-section
-                std::string sub_action = determine_action(sub_section->get_section_type(), sub_name);
+                // Determine action for the sub-section, by the type it
+                // inherits from the sections around it
+                std::string sub_action = determine_action(sub_section->get_effective_type(), sub_name);
                 
                 // Process the properties of the sub-section
                 std::vector<std::string> sub_property_params;
@@ -537,7 +632,7 @@ if (type == SectionType::INTERFACES) {
                 
                 if (sub_section->get_block()) {
                     for (const auto* sub_stmt : sub_section->get_block()->get_statements()) {
-                        if (const auto* sub_prop = dynamic_cast<const PropertyStatement*>(sub_stmt)) {
+                        if (const auto* sub_prop = node_cast<PropertyStatement>(sub_stmt)) {
                             sub_property_params.push_back(sub_prop->to_mikrotik(""));
                         } else {
                             // For deeper nested statements, use regular processing with increased indentation
@@ -588,22 +683,13 @@ if (type == SectionType::INTERFACES) {
 
 // DeclarationStatement implementation
 DeclarationStatement::DeclarationStatement(Declaration* decl) noexcept 
-    : declaration(decl) {}
+    : Statement(NodeKind::DECLARATION_STATEMENT), declaration(decl) {}
 
 Declaration* DeclarationStatement::get_declaration() const noexcept 
 {
     return declaration;
 }
 
-void DeclarationStatement::destroy() noexcept 
-{
-    if (declaration) {
-        declaration->destroy();
-        delete declaration;
-        declaration = nullptr;
-    }
-}
-
 std::string DeclarationStatement::to_string() const 
 {
     return declaration ? declaration->to_string() : "null";
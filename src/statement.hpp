@@ -1,8 +1,14 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+
 #include "ast_node_interface.hpp"
 #include "expression.hpp"
 #include "datatype.hpp"
+#include "symbol_table.hpp"
 
 // Forward declaration
 class Declaration;
@@ -10,43 +16,95 @@ class Declaration;
 // Base class for all statements
 class Statement : public ASTNodeInterface
 {
-    // Empty base class
+public:
+    explicit Statement(NodeKind kind) noexcept;
+
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::PROPERTY_STATEMENT, NodeKind::CUSTOM_SECTION);
+    }
 };
 
 // Property assignment statement (key = value)
 class PropertyStatement : public Statement
 {
 public:
-    PropertyStatement(std::string_view name, Expression* value) noexcept;
+    // symbol is the interned name
+    PropertyStatement(std::string_view name, Expression* value, Symbol symbol) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::PROPERTY_STATEMENT; }
     
-    const std::string& get_name() const noexcept;
+    // The name references the source text (see ParserContext), it is not copied
+    std::string_view get_name() const noexcept;
+    // The name as a symbol, to match it against known names
+    Symbol get_symbol() const noexcept;
     Expression* get_value() const noexcept;
-    void destroy() noexcept override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
-    std::string name;
+    std::string_view name;
     Expression* value;
+    Symbol symbol;
 };
 
 // Block statement (a collection of statements)
 class BlockStatement : public Statement
 {
 public:
-    BlockStatement() noexcept;
-    BlockStatement(const StatementList& statements) noexcept;
+    // The statement list is allocated from resource (the AstArena)
+    explicit BlockStatement(std::pmr::memory_resource* resource) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::BLOCK_STATEMENT; }
     
     // Add a statement to this block
     void add_statement(Statement* statement) noexcept;
+
+    // Builds the index of the properties by symbol that find_property()
+    // searches; the parser calls it once the block is complete. A block
+    // that was not indexed (or got statements since) is searched linearly.
+    void index_properties();
     
     const StatementList& get_statements() const noexcept;
-    void destroy() noexcept override;
+
+    // The property of the block named symbol, the last one if it is
+    // assigned more than once (later assignments win), or nullptr
+    const PropertyStatement* find_property(Symbol symbol) const noexcept;
+    // The same for a property with two spellings (src_address and
+    // src-address): whichever was assigned last
+    const PropertyStatement* find_property(Symbol symbol, Symbol alias) const noexcept;
+
+    // Value of find_property(symbol) if it is a string (referencing the
+    // source text) or a number; nothing if missing or of another type
+    std::optional<std::string_view> get_string(Symbol symbol) const noexcept;
+    std::optional<int> get_int(Symbol symbol) const noexcept;
+
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
 private:
+    struct PropertyEntry {
+        Symbol symbol;
+        uint32_t position;  // In statements, to tell which alias came last
+        const PropertyStatement* property;
+    };
+
+    static constexpr size_t known_words = (static_cast<size_t>(Symbol::FIRST_INTERNED) + 63) / 64;
+
+    size_t known_rank(Symbol symbol) const noexcept;
+    const PropertyEntry* find_entry(Symbol symbol) const noexcept;
+
     StatementList statements;
+    // The property index, in the AstArena like the statements. The known
+    // symbols the block assigns have a bit each in known_assigned and one
+    // entry each (their last assignment), first and in symbol order, so the
+    // entry of one is at the count of bits set below its own. The interned
+    // names follow in block order.
+    std::array<uint64_t, known_words> known_assigned{};
+    PropertyEntry* property_index = nullptr;
+    uint32_t known_count = 0;
+    uint32_t property_count = 0;
+    bool indexed = false;
 };
 
 // Section statement (named block with type)
@@ -66,12 +124,29 @@ public:
     
     SectionStatement(std::string_view name, SectionType type) noexcept;
     SectionStatement(std::string_view name, SectionType type, BlockStatement* block) noexcept;
+
+    // Plain sections and every specialized section
+    static bool classof(NodeKind kind) noexcept
+    {
+        return kind_in(kind, NodeKind::SECTION_STATEMENT, NodeKind::CUSTOM_SECTION);
+    }
     
     // Add parent setter/getter
     void set_parent(SectionStatement* parent) noexcept;
     SectionStatement* get_parent() const noexcept;
-    
-    const std::string& get_name() const noexcept;
+
+    // Sets the parent, effective type, path and depth of every section
+    // nested in this one, at any depth, once the section is complete (the
+    // program does it for its top-level sections). Paths are taken from
+    // resource.
+    void link_subsections(std::pmr::memory_resource* resource);
+    
+    // The name references the source text (see ParserContext), it is not copied
+    std::string_view get_name() const noexcept;
+    // The name as a symbol (set by the SectionFactory), to match it
+    // against known names
+    Symbol get_symbol() const noexcept;
+    void set_symbol(Symbol name_symbol) noexcept;
     SectionType get_section_type() const noexcept;
     BlockStatement* get_block() const noexcept;
     
@@ -84,18 +159,34 @@ public:
     // Static method to determine the RouterOS action based on section type and name
     static std::string determine_action(SectionType type, const std::string& section_name);
     
-    void destroy() noexcept override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident = "") const override;
     
-    // Get effective type based on parent context
+    // Get effective type based on parent context: a custom section nested
+    // in interfaces, ip, routing or firewall, at any depth, takes its type
     SectionType get_effective_type() const noexcept;
+
+    // Names from the top-level section down to this one, e.g.
+    // "firewall/nat/masq_country_a"; just the name until it is linked
+    std::string_view get_path() const noexcept;
+
+    // Sections between this one and its top-level section, counting
+    // itself: 0 for a top-level section, 1 for its subsections and so on
+    unsigned get_depth() const noexcept;
     
 protected:
-    std::string name;
+    // For subclasses, with their own kind
+    SectionStatement(NodeKind kind, std::string_view name, SectionType type) noexcept;
+
+    std::string_view name;
+    Symbol symbol = Symbol::NONE;
     SectionType type;
     BlockStatement* block;
     SectionStatement* parent_section;
+    // Resolved by link_subsections() from the parent
+    SectionType effective_type = SectionType::CUSTOM;
+    std::string_view path;
+    uint16_t depth = 0;
 };
 
 // Declaration statement (wrapper for a declaration)
@@ -103,9 +194,10 @@ class DeclarationStatement : public Statement
 {
 public:
     DeclarationStatement(Declaration* decl) noexcept;
+
+    static bool classof(NodeKind kind) noexcept { return kind == NodeKind::DECLARATION_STATEMENT; }
     
     Declaration* get_declaration() const noexcept;
-    void destroy() noexcept override;
     std::string to_string() const override;
     std::string to_mikrotik(const std::string& ident) const override;
     
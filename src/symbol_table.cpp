@@ -0,0 +1,82 @@
+#include "symbol_table.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const uint32_t known_symbol_count = static_cast<uint32_t>(Symbol::FIRST_INTERNED);
+
+static_assert(sizeof(known_symbol_names) / sizeof(known_symbol_names[0]) == known_symbol_count,
+              "one spelling per known symbol");
+
+// Names interned at run time. Lookups of names already interned only take
+// the lock shared, so parser threads rarely wait on each other.
+struct InternedNames
+{
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, Symbol> symbols;  // Views of names
+    std::deque<std::string> names;  // By symbol - FIRST_INTERNED, never moved
+};
+
+const std::unordered_map<std::string_view, Symbol>& known_symbols()
+{
+    static const std::unordered_map<std::string_view, Symbol> symbols = [] {
+        std::unordered_map<std::string_view, Symbol> table;
+        for (uint32_t i = 1; i < known_symbol_count; ++i) {
+            table.emplace(known_symbol_names[i], static_cast<Symbol>(i));
+        }
+        return table;
+    }();
+    return symbols;
+}
+
+InternedNames& interned_names()
+{
+    static InternedNames interned;
+    return interned;
+}
+
+} // namespace
+
+Symbol intern_symbol(std::string_view name)
+{
+    const auto& known = known_symbols();
+    auto known_symbol = known.find(name);
+    if (known_symbol != known.end()) {
+        return known_symbol->second;
+    }
+
+    InternedNames& interned = interned_names();
+    {
+        std::shared_lock<std::shared_mutex> lock(interned.mutex);
+        auto symbol = interned.symbols.find(name);
+        if (symbol != interned.symbols.end()) {
+            return symbol->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(interned.mutex);
+    auto symbol = interned.symbols.find(name);
+    if (symbol != interned.symbols.end()) {
+        return symbol->second;
+    }
+    Symbol next = static_cast<Symbol>(known_symbol_count + interned.names.size());
+    interned.names.emplace_back(name);
+    interned.symbols.emplace(interned.names.back(), next);
+    return next;
+}
+
+std::string_view symbol_name(Symbol symbol)
+{
+    uint32_t index = static_cast<uint32_t>(symbol);
+    if (index < known_symbol_count) {
+        return known_symbol_names[index];
+    }
+    InternedNames& interned = interned_names();
+    std::shared_lock<std::shared_mutex> lock(interned.mutex);
+    return index - known_symbol_count < interned.names.size() ? interned.names[index - known_symbol_count] : "";
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Interned names. Every property and section name is interned once per
+// process and its node keeps the Symbol, so translators and validators match
+// names with an integer compare or a switch instead of comparing text. The
+// names they look for are in symbols.def and have constant symbols; any
+// other name gets the next free number the first time it is interned.
+enum class Symbol : uint32_t {
+    NONE,
+#define NETFORGE_SYMBOL(identifier, spelling) identifier,
+#include "symbols.def"
+#undef NETFORGE_SYMBOL
+    FIRST_INTERNED    // Names interned at run time follow
+};
+
+// Spellings of the known symbols, indexed by symbol
+inline constexpr std::string_view known_symbol_names[] = {
+    "",
+#define NETFORGE_SYMBOL(identifier, spelling) spelling,
+#include "symbols.def"
+#undef NETFORGE_SYMBOL
+};
+
+// Symbol of name, interned on first use; the same name always gives the same
+// symbol. Safe to call from several threads at once.
+Symbol intern_symbol(std::string_view name);
+
+// Spelling of a symbol ("" for Symbol::NONE)
+std::string_view symbol_name(Symbol symbol);
+
+// Spelling of a known symbol, for keywords the parser turns into names
+constexpr std::string_view known_symbol_name(Symbol symbol) noexcept
+{
+    return known_symbol_names[static_cast<uint32_t>(symbol)];
+}
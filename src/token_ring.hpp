@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// FIFO of pending INDENT/DEDENT/NEWLINE tokens: a ring buffer with a power
+// of two capacity, so both ends are O(1). It only grows if one dedentation
+// burst is deeper than the current capacity.
+class TokenRing
+{
+public:
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    void push_back(int token)
+    {
+        if (count == slots.size()) {
+            grow();
+        }
+        slots[(head + count) & (slots.size() - 1)] = token;
+        ++count;
+    }
+
+    // Oldest token; the ring must not be empty
+    int pop_front() noexcept
+    {
+        int token = slots[head];
+        head = (head + 1) & (slots.size() - 1);
+        --count;
+        return token;
+    }
+
+private:
+    void grow()
+    {
+        std::vector<int> larger(slots.size() * 2);
+        for (size_t i = 0; i < count; ++i) {
+            larger[i] = slots[(head + i) & (slots.size() - 1)];
+        }
+        slots.swap(larger);
+        head = 0;
+    }
+
+    std::vector<int> slots = std::vector<int>(16);
+    size_t head = 0;
+    size_t count = 0;
+};
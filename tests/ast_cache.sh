@@ -0,0 +1,53 @@
+#!/bin/sh
+# .astc cache: a second compilation of an unchanged file loads the cached
+# AST and gives the same script; a changed input or a damaged cache is
+# parsed again, still with the same script as without the cache
+# Usage: ast_cache.sh compiler
+compiler=$1
+tests=$(dirname "$0")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+# Compiles input to work/out.rsc (cache work/out.astc) and checks the
+# script against a compilation without the cache; loaded tells whether the
+# cached AST must have been used (yes) or not (no)
+check_compile() {
+    "$compiler" "$1" "$work/out.rsc" 2> "$work/log"
+    NO_AST_CACHE=1 "$compiler" "$1" - > "$work/plain.rsc" 2> /dev/null
+    if ! cmp -s "$work/out.rsc" "$work/plain.rsc"; then
+        echo "$2: the script differs from a compilation without the cache"
+        diff "$work/plain.rsc" "$work/out.rsc"
+        failed=1
+    fi
+    if grep -q "AST loaded" "$work/log"; then
+        loaded=yes
+    else
+        loaded=no
+    fi
+    if [ "$loaded" != "$3" ]; then
+        echo "$2: cached AST loaded: $loaded, expected $3"
+        failed=1
+    fi
+}
+
+for example in simple complex; do
+    cp "$tests/../examples/$example.dsl" "$work/input.dsl"
+    rm -f "$work/out.astc"
+
+    check_compile "$work/input.dsl" "$example, first compilation" no
+    [ -f "$work/out.astc" ] || { echo "$example: no cache written"; failed=1; }
+    check_compile "$work/input.dsl" "$example, unchanged" yes
+
+    sed 's/hostname = "\([^"]*\)"/hostname = "\1-2"/' "$tests/../examples/$example.dsl" > "$work/input.dsl"
+    check_compile "$work/input.dsl" "$example, changed" no
+    grep -q -- '-2' "$work/out.rsc" || { echo "$example: the change is not in the script"; failed=1; }
+
+    # Damage the body of the cache, the header stays valid
+    if [ -f "$work/out.astc" ]; then
+        size=$(wc -c < "$work/out.astc")
+        printf 'XXXX' | dd of="$work/out.astc" bs=1 seek=$((size / 2)) conv=notrunc 2> /dev/null
+        check_compile "$work/input.dsl" "$example, damaged cache" no
+    fi
+done
+exit $failed
@@ -0,0 +1,70 @@
+// Deeply nested sections: the parser stacks grow past their initial depth
+// (200 entries, some 50 levels) up to YYMAXDEPTH, and deeper input is a
+// syntax error, not a crash.
+#include <stdio.h>
+#include <string>
+
+#include "parser_context.hpp"
+#include "statement.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// An interfaces section with levels nested sections, one property in the
+// innermost
+static std::string nested_input(unsigned levels)
+{
+    std::string text = "interfaces:\n";
+    std::string indent;
+    for (unsigned i = 0; i < levels; ++i) {
+        indent += "    ";
+        text += indent + "level" + std::to_string(i) + ":\n";
+    }
+    text += indent + "    mtu = 1500\n";
+    return text;
+}
+
+// Depth of the innermost section, following the first subsection of each
+static unsigned innermost_depth(const SectionStatement* section)
+{
+    for (;;) {
+        const SectionStatement* next = nullptr;
+        for (const Statement* statement : section->get_block()->get_statements()) {
+            if ((next = node_cast<SectionStatement>(statement))) {
+                break;
+            }
+        }
+        if (next == nullptr) {
+            return section->get_depth();
+        }
+        section = next;
+    }
+}
+
+int main()
+{
+    for (unsigned levels : {300u, 2000u}) {
+        std::string text = nested_input(levels);
+        ParserContext ctx;
+        bool parsed = netforge_parse_buffer(ctx, text.data(), text.size()) == 0 && ctx.result != nullptr &&
+                      ctx.result->get_sections().size() == 1;
+        check(parsed, std::to_string(levels) + " levels parse");
+        if (parsed) {
+            check(innermost_depth(ctx.result->get_sections()[0]) == levels,
+                  std::to_string(levels) + " levels are all in the AST");
+        }
+    }
+
+    std::string text = nested_input(5000);
+    ParserContext ctx;
+    check(netforge_parse_buffer(ctx, text.data(), text.size()) != 0 && !ctx.syntax_errors.empty(),
+          "5000 levels are a syntax error");
+    return failures == 0 ? 0 : 1;
+}
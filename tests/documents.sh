@@ -0,0 +1,50 @@
+#!/bin/sh
+# "---" documents: each script of a multi-document input, on stdout or in
+# an output directory, is the script of its document compiled alone
+# Usage: documents.sh compiler
+compiler=$1
+tests=$(dirname "$0")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+{
+    cat "$tests/../examples/simple.dsl"
+    echo "---"
+    cat "$tests/../examples/complex.dsl"
+    echo "---"
+    cat "$tests/document_names.dsl"
+} > "$work/fleet.dsl"
+
+# One file per document, doc1.dsl and on
+awk -v dir="$work" 'BEGIN { n = 1 } /^---[ \t]*$/ { n++; next } { print > (dir "/doc" n ".dsl") }' "$work/fleet.dsl"
+
+"$compiler" "$work/fleet.dsl" - > "$work/fleet.rsc" 2> /dev/null
+mkdir "$work/out"
+"$compiler" -j 4 "$work/fleet.dsl" "$work/out/" 2> /dev/null
+
+n=0
+for name in $(sed -n 's/^# Document [0-9]*: //p' "$work/fleet.rsc"); do
+    n=$((n + 1))
+    if ! "$compiler" "$work/doc$n.dsl" - > "$work/alone.rsc" 2> /dev/null; then
+        echo "document $n ($name) does not compile alone"
+        failed=1
+    fi
+    if ! cmp -s "$work/alone.rsc" "$work/out/$name.rsc"; then
+        echo "document $n ($name) differs from its file compiled alone"
+        diff "$work/alone.rsc" "$work/out/$name.rsc"
+        failed=1
+    fi
+    # On stdout: the document's script after its header
+    awk -v n="$n" '/^# Document [0-9]*: / { current = ($3 == n ":"); next } current' "$work/fleet.rsc" > "$work/stdout.rsc"
+    if ! cmp -s "$work/alone.rsc" "$work/stdout.rsc"; then
+        echo "document $n ($name) on stdout differs from its file compiled alone"
+        diff "$work/alone.rsc" "$work/stdout.rsc"
+        failed=1
+    fi
+done
+if [ $n -ne 6 ] || [ "$(ls "$work/out" | wc -l)" -ne 6 ]; then
+    echo "expected 6 documents, got $n headers and $(ls "$work/out" | wc -l) files"
+    failed=1
+fi
+exit $failed
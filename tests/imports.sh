@@ -0,0 +1,58 @@
+#!/bin/sh
+# import: a program whose sections come from imported files gives the
+# script of the same program written in one file, also when a file is
+# imported on two paths and when the modules come from NETFORGE_CACHE_DIR
+# Usage: imports.sh compiler
+compiler=$1
+tests=$(dirname "$0")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+# Top-level sections of the example named in the comma-separated list
+select_sections() {
+    awk -v sections=",$1," '/^[a-z]/ { keep = index(sections, "," substr($1, 1, length($1) - 1) ",") > 0 } keep' \
+        "$tests/../examples/complex.dsl"
+}
+
+# complex.dsl split in files: net/interfaces.dsl, net/ip.dsl (importing
+# interfaces.dsl) and main.dsl importing both, with the other sections
+mkdir "$work/net"
+select_sections interfaces > "$work/net/interfaces.dsl"
+{ echo 'import "interfaces.dsl"'; select_sections ip; } > "$work/net/ip.dsl"
+{
+    select_sections device
+    echo 'import "net/ip.dsl"'
+    echo 'import "net/interfaces.dsl"'
+    select_sections routing,firewall
+} > "$work/main.dsl"
+select_sections device,interfaces,ip,routing,firewall > "$work/whole.dsl"
+
+if ! "$compiler" "$work/whole.dsl" - > "$work/whole.rsc" 2> /dev/null; then
+    echo "the program in one file does not compile"
+    exit 1
+fi
+compare() {
+    if ! cmp -s "$work/whole.rsc" "$work/imported.rsc"; then
+        echo "$1: differs from the program in one file"
+        diff "$work/whole.rsc" "$work/imported.rsc"
+        failed=1
+    fi
+}
+
+"$compiler" "$work/main.dsl" - > "$work/imported.rsc" 2> /dev/null
+compare "imports"
+"$compiler" -j 4 "$work/main.dsl" - > "$work/imported.rsc" 2> /dev/null
+compare "imports with -j 4"
+
+# The module without imports of its own is kept in the cache directory
+mkdir "$work/cache"
+NETFORGE_CACHE_DIR="$work/cache" "$compiler" "$work/main.dsl" - > "$work/imported.rsc" 2> /dev/null
+compare "imports, cache directory filled"
+if [ "$(ls "$work/cache" | wc -l)" -ne 1 ]; then
+    echo "expected one module in the cache directory, got: $(ls "$work/cache")"
+    failed=1
+fi
+NETFORGE_CACHE_DIR="$work/cache" "$compiler" "$work/main.dsl" - > "$work/imported.rsc" 2> /dev/null
+compare "imports, modules from the cache directory"
+exit $failed
@@ -0,0 +1,134 @@
+// Module cache: a file imported by several programs is parsed once and
+// shared, and a program importing a module whose own import changed gets
+// the new sections, not the ones cached with the module.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+
+#include "module_cache.hpp"
+#include "parser_context.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+static void write_file(const std::string& path, const char* text)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        perror(path.c_str());
+        exit(1);
+    }
+    fputs(text, file);
+    fclose(file);
+}
+
+// Parses path and returns its script, "" if it did not parse
+static std::string compile(ParserContext& ctx, const std::string& path)
+{
+    ctx.source_path = path;
+    if (netforge_parse_path(ctx, path.c_str()) != 0 || ctx.result == nullptr) {
+        return std::string();
+    }
+    return ctx.result->to_mikrotik("");
+}
+
+static const Module* imported(const ParserContext& ctx, const char* name)
+{
+    for (const auto& module : ctx.imports) {
+        if (module->path.size() >= strlen(name) &&
+            module->path.compare(module->path.size() - strlen(name), std::string::npos, name) == 0) {
+            return module.get();
+        }
+    }
+    return nullptr;
+}
+
+int main()
+{
+    char directory_template[] = "/tmp/netforge-module-cache-XXXXXX";
+    const char* directory = mkdtemp(directory_template);
+    if (directory == nullptr) {
+        perror("mkdtemp");
+        return 1;
+    }
+    std::string base = std::string(directory) + "/";
+    std::string vlans = base + "vlans.dsl";
+    std::string interfaces = base + "interfaces.dsl";
+    std::string first = base + "first.dsl";
+    std::string second = base + "second.dsl";
+
+    write_file(vlans,
+               "interfaces:\n"
+               "    vlan10:\n"
+               "        type = \"vlan\"\n"
+               "        vlan_id = 10\n"
+               "        interface = \"ether2\"\n");
+    write_file(interfaces,
+               "import \"vlans.dsl\"\n"
+               "ip:\n"
+               "    ether1:\n"
+               "        address = \"10.0.0.1/24\"\n");
+    write_file(first,
+               "import \"interfaces.dsl\"\n"
+               "device:\n"
+               "    vendor = \"mikrotik\"\n"
+               "    hostname = \"first\"\n");
+    write_file(second,
+               "import \"interfaces.dsl\"\n"
+               "import \"vlans.dsl\"\n"
+               "device:\n"
+               "    vendor = \"mikrotik\"\n"
+               "    hostname = \"second\"\n");
+
+    // Reuse: both programs get the same modules, vlans.dsl once each
+    ParserContext first_ctx;
+    std::string first_script = compile(first_ctx, first);
+    ParserContext second_ctx;
+    std::string second_script = compile(second_ctx, second);
+    check(!first_script.empty() && !second_script.empty(), "programs with imports compile");
+    check(first_ctx.imports.size() == 2 && second_ctx.imports.size() == 2, "each module is spliced once");
+    check(imported(first_ctx, "/interfaces.dsl") != nullptr &&
+          imported(first_ctx, "/interfaces.dsl") == imported(second_ctx, "/interfaces.dsl"),
+          "interfaces.dsl is shared");
+    check(imported(first_ctx, "/vlans.dsl") != nullptr &&
+          imported(first_ctx, "/vlans.dsl") == imported(second_ctx, "/vlans.dsl"),
+          "vlans.dsl is shared, directly or not");
+    check(first_script.find("vlan-id=10") != std::string::npos, "sections of a nested import are spliced");
+
+    // Invalidation: vlans.dsl changes, interfaces.dsl does not
+    write_file(vlans,
+               "interfaces:\n"
+               "    vlan20:\n"
+               "        type = \"vlan\"\n"
+               "        vlan_id = 20\n"
+               "        interface = \"ether2\"\n");
+    ParserContext changed_ctx;
+    std::string changed_script = compile(changed_ctx, first);
+    check(changed_script.find("vlan-id=20") != std::string::npos &&
+          changed_script.find("vlan-id=10") == std::string::npos,
+          "a changed nested import is loaded again");
+    check(imported(changed_ctx, "/interfaces.dsl") != imported(first_ctx, "/interfaces.dsl"),
+          "the module importing it is loaded again");
+
+    // Unchanged again: the reloaded modules are reused
+    ParserContext again_ctx;
+    compile(again_ctx, first);
+    check(imported(again_ctx, "/interfaces.dsl") == imported(changed_ctx, "/interfaces.dsl"),
+          "the reloaded module is cached");
+
+    for (const std::string& path : {vlans, interfaces, first, second}) {
+        unlink(path.c_str());
+    }
+    rmdir(directory);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# --only: compiling some top-level sections of a file gives the script of a
+# file holding just those sections
+# Usage: only_sections.sh compiler
+compiler=$1
+tests=$(dirname "$0")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+# Top-level sections of input named in the comma-separated list sections
+select_sections() {
+    awk -v sections=",$2," '/^[a-z]/ { keep = index(sections, "," substr($1, 1, length($1) - 1) ",") > 0 } keep' "$1"
+}
+
+for input in "$tests"/../examples/simple.dsl "$tests"/../examples/complex.dsl; do
+    for sections in interfaces ip,routing firewall,device; do
+        select_sections "$input" "$sections" > "$work/selected.dsl"
+        if ! "$compiler" "$work/selected.dsl" - > "$work/selected.rsc" 2> /dev/null; then
+            echo "the $sections sections of $input do not compile alone"
+            failed=1
+        fi
+        "$compiler" --only "$sections" "$input" - > "$work/only.rsc" 2> /dev/null
+        if ! cmp -s "$work/selected.rsc" "$work/only.rsc"; then
+            echo "--only $sections of $input differs from a file with those sections"
+            diff "$work/selected.rsc" "$work/only.rsc"
+            failed=1
+        fi
+    done
+done
+exit $failed
@@ -0,0 +1,22 @@
+#!/bin/sh
+# -j: every example and test input gives the same script, diagnostics and
+# exit status with the top-level sections parsed on 4 threads as without
+# Usage: parallel.sh compiler
+compiler=$1
+tests=$(dirname "$0")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+for input in "$tests"/../examples/*.dsl "$tests"/*.dsl; do
+    "$compiler" "$input" - > "$work/plain.out" 2>&1
+    echo "exit $?" >> "$work/plain.out"
+    "$compiler" -j 4 "$input" - > "$work/parallel.out" 2>&1
+    echo "exit $?" >> "$work/parallel.out"
+    if ! cmp -s "$work/plain.out" "$work/parallel.out"; then
+        echo "-j 4 changes the output of $input"
+        diff "$work/plain.out" "$work/parallel.out"
+        failed=1
+    fi
+done
+exit $failed
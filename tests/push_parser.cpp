@@ -0,0 +1,95 @@
+// Push parser: every example and test input fed to netforge_feed in chunks
+// of random sizes (and one byte at a time) must give the same parse result,
+// syntax errors and scripts as the whole input parsed at once. Run from src
+// (make test), the inputs are found relative to it.
+#include <glob.h>
+#include <stdio.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "parser_context.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// Parse result, syntax errors and the script of each document, as text
+static std::string describe(const ParserContext& ctx, int result)
+{
+    std::string text = "result " + std::to_string(result) + "\n";
+    for (const auto& error : ctx.syntax_errors) {
+        text += "error at " + std::to_string(error.span.offset) + ": " + error.message + "\n";
+    }
+    if (result == 0) {
+        for (const auto& document : ctx.documents) {
+            text += "document\n" + document.program->to_mikrotik("");
+        }
+    }
+    return text;
+}
+
+static std::string parse_whole(const std::string& source)
+{
+    ParserContext ctx;
+    int result = netforge_parse_buffer(ctx, source.data(), source.size());
+    return describe(ctx, result);
+}
+
+// Feeds source in chunks of 1 to max_chunk bytes
+static std::string parse_fed(const std::string& source, std::mt19937& random, size_t max_chunk)
+{
+    ParserContext ctx;
+    std::uniform_int_distribution<size_t> chunk_size(1, max_chunk);
+    for (size_t offset = 0; offset < source.size();) {
+        size_t length = std::min(chunk_size(random), source.size() - offset);
+        netforge_feed(ctx, source.data() + offset, length);
+        offset += length;
+    }
+    int result = netforge_finish(ctx);
+    return describe(ctx, result);
+}
+
+static std::vector<std::string> inputs()
+{
+    std::vector<std::string> paths;
+    for (const char* pattern : {"../examples/*.dsl", "../tests/*.dsl"}) {
+        glob_t matches;
+        if (glob(pattern, 0, nullptr, &matches) == 0) {
+            paths.insert(paths.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+        }
+        globfree(&matches);
+    }
+    return paths;
+}
+
+int main()
+{
+    std::vector<std::string> paths = inputs();
+    check(!paths.empty(), "inputs found in ../examples and ../tests");
+
+    std::mt19937 random(2024);
+    for (const std::string& path : paths) {
+        std::ifstream file(path);
+        std::stringstream source;
+        source << file.rdbuf();
+        std::string whole = parse_whole(source.str());
+
+        check(parse_fed(source.str(), random, 1) == whole, path + " fed one byte at a time");
+        for (size_t max_chunk : {7, 64, 4096}) {
+            for (int run = 0; run < 5; ++run) {
+                check(parse_fed(source.str(), random, max_chunk) == whole,
+                      path + " fed in chunks of up to " + std::to_string(max_chunk) + " bytes");
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}